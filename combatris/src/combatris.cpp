@@ -1,19 +1,18 @@
 #include "game/tetrion.h"
-
-#include <functional>
-#include <set>
+#include "utility/auto_repeat.h"
+#include "utility/input_capture.h"
+#include "utility/trace.h"
 
 namespace {
 
-// DAS settings
-const int64_t kAutoRepeatInitialDelay = 300; // milliseconds
-const int64_t kAutoRepeatSubsequentDelay = 50; // milliseconds
+// DAS settings, an auto repeat rate of 0 shifts to the wall as soon as the DAS has elapsed
+const int64_t kDelayedAutoShift = 300; // milliseconds
+const int64_t kAutoRepeatRate = 50; // milliseconds
+const int kSoftDropFactor = 1;
 
-const std::set<Tetrion::Controls> kAutoRepeatControls = {
-  Tetrion::Controls::SoftDrop,
-  Tetrion::Controls::Left,
-  Tetrion::Controls::Right
-};
+const int64_t kNanosecondsPerMs = 1000000;
+
+const std::string kTraceFileName = "combatris.trace";
 
 } // namespace
 
@@ -21,7 +20,7 @@ using namespace utility;
 
 class Combatris {
  public:
-  using RepeatFunc = std::function<void()>;
+  using AutoRepeat = utility::AutoRepeat<Tetrion::Controls>;
 
   Combatris() {
     if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
@@ -33,9 +32,12 @@ class Combatris {
       exit(-1);
     }
     tetrion_ = std::make_shared<Tetrion>();
+    input_capture_ = std::make_shared<InputCapture>();
+    Trace::DumpOnCrash(kTraceFileName);
   }
 
   ~Combatris() {
+    input_capture_.reset();
     tetrion_.reset();
     SDL_Quit();
     TTF_Quit();
@@ -69,6 +71,8 @@ class Combatris {
       return Tetrion::Controls::HideMultiplayerPanel;
     } else if (SDL_SCANCODE_Q == code) {
       return Tetrion::Controls::Quit;
+    } else if (SDL_SCANCODE_F12 == code) {
+      return Tetrion::Controls::DumpTrace;
     } else if (code >=  SDL_SCANCODE_1 && code <=  SDL_SCANCODE_9) {
       return Tetrion::Controls::DebugSendLine;
     }
@@ -103,105 +107,129 @@ class Combatris {
     return Tetrion::Controls::None;
   }
 
-  template <Tetrion::Controls control>
-  std::pair<Tetrion::Controls, RepeatFunc> Repeatable(int& repeat_count, int64_t& time_since_last_auto_repeat) {
-    repeat_count = 0;
-    time_since_last_auto_repeat = kAutoRepeatInitialDelay;
-    return std::make_pair(control, [&tetrion = tetrion_]() { tetrion->GameControl(control); });
+  void Repeat(AutoRepeat& auto_repeat) {
+    const auto repeats = auto_repeat.Update(time_in_ns() / kNanosecondsPerMs);
+
+    if (AutoRepeat::kRepeatToWall == repeats) {
+      if (Tetrion::Controls::Left == auto_repeat.control()) {
+        tetrion_->GameControl(Tetrion::Controls::LeftToWall);
+      } else if (Tetrion::Controls::Right == auto_repeat.control()) {
+        tetrion_->GameControl(Tetrion::Controls::RightToWall);
+      }
+      return;
+    }
+    for (int i = 0; i < repeats; ++i) {
+      tetrion_->GameControl(auto_repeat.control());
+    }
   }
 
-  void Play() {
-    bool quit = false;
-    DeltaTimer delta_timer;
-    int repeat_count = 0;
-    int64_t time_since_last_auto_repeat = 0;
-    int64_t auto_repeat_threshold = kAutoRepeatInitialDelay;
-    RepeatFunc function_to_repeat;
-    auto active_control = Tetrion::Controls::None;
-    SDL_Event event;
-
-    while (!quit) {
-      auto control = Tetrion::Controls::None;
-
-      while (SDL_PollEvent(&event)) {
-        if (SDL_QUIT == event.type) {
-          quit = true;
-          break;
-        }
-        switch (event.type) {
-          case SDL_KEYDOWN:
-            control = TranslateKeyboardCommands(event);
-            break;
-          case SDL_CONTROLLERBUTTONDOWN:
-            control = TranslateControllerCommands(event);
-            break;
-          case SDL_KEYUP:
-            if (TranslateKeyboardCommands(event) == active_control) {
-              active_control = Tetrion::Controls::None;
-            }
-            break;
-          case SDL_CONTROLLERBUTTONUP:
-            if (TranslateControllerCommands(event) == active_control) {
-              active_control = Tetrion::Controls::None;
-            }
-            break;
-          case SDL_JOYDEVICEADDED:
-          case SDL_CONTROLLERDEVICEADDED:
-          case SDL_JOYDEVICEREMOVED:
-          case SDL_CONTROLLERDEVICEREMOVED:
-            tetrion_->HandleGameControllerEvents(event);
-            break;
+  // Returns true if the player wants to quit
+  bool HandleInput(const InputCapture::TimedEvent& input, AutoRepeat& auto_repeat) {
+    const auto& event = input.event_;
+    auto control = Tetrion::Controls::None;
+
+    switch (event.type) {
+      case SDL_KEYDOWN:
+        control = TranslateKeyboardCommands(event);
+        break;
+      case SDL_CONTROLLERBUTTONDOWN:
+        control = TranslateControllerCommands(event);
+        break;
+      case SDL_KEYUP:
+        auto_repeat.Release(TranslateKeyboardCommands(event));
+        return false;
+      case SDL_CONTROLLERBUTTONUP:
+        auto_repeat.Release(TranslateControllerCommands(event));
+        return false;
+    }
+    switch (control) {
+      case Tetrion::Controls::None:
+        return false;
+      case Tetrion::Controls::Left:
+      case Tetrion::Controls::Right:
+      case Tetrion::Controls::SoftDrop:
+        tetrion_->GameControl(control);
+        auto_repeat.Press(control, input.timestamp_ / kNanosecondsPerMs);
+        break;
+      case Tetrion::Controls::Start:
+        tetrion_->NewGame();
+        auto_repeat.Reset();
+        break;
+      case Tetrion::Controls::Pause:
+        tetrion_->Pause();
+        auto_repeat.Reset();
+        break;
+      case Tetrion::Controls::Quit:
+        return true;
+      case Tetrion::Controls::DumpTrace:
+        if (!Trace::Dump(kTraceFileName)) {
+          std::cout << "Failed to write " << kTraceFileName << std::endl;
         }
-      }
-      switch (control) {
-        case Tetrion::Controls::None:
-          break;
-        case Tetrion::Controls::Left:
-          std::tie(active_control, function_to_repeat) =
-              Repeatable<Tetrion::Controls::Left>(repeat_count, time_since_last_auto_repeat);
-          break;
-        case Tetrion::Controls::Right:
-          std::tie(active_control, function_to_repeat) =
-              Repeatable<Tetrion::Controls::Right>(repeat_count, time_since_last_auto_repeat);
-          break;
-        case Tetrion::Controls::SoftDrop:
-          std::tie(active_control, function_to_repeat) =
-              Repeatable<Tetrion::Controls::SoftDrop>(repeat_count, time_since_last_auto_repeat);
-          break;
-        case Tetrion::Controls::Start:
-          tetrion_->NewGame();
-          active_control = control;
-          break;
-        case Tetrion::Controls::Pause:
-          tetrion_->Pause();
-          active_control = control;
-          break;
-        case Tetrion::Controls::Quit:
-          quit = true;
-          break;
-        case Tetrion::Controls::DebugSendLine:
+        input_capture_->ReportLatency(std::cout);
+        tetrion_->ReportEventStatistics(std::cout);
+        break;
+      case Tetrion::Controls::DebugSendLine:
 #if !defined(NDEBUG)
-          tetrion_->GameControl(Tetrion::Controls::DebugSendLine, 9 - (SDL_SCANCODE_9 - event.key.keysym.scancode));
-          active_control = control;
+        tetrion_->GameControl(Tetrion::Controls::DebugSendLine, 9 - (SDL_SCANCODE_9 - event.key.keysym.scancode));
 #endif
+        break;
+      default:
+        tetrion_->GameControl(control);
+        break;
+    }
+    input_capture_->Applied(input);
+
+    return false;
+  }
+
+  // Returns true if the player wants to quit
+  bool PollEvents(AutoRepeat& auto_repeat) {
+    InputCapture::TimedEvent input;
+
+    input_capture_->Begin();
+    while (input_capture_->Poll(input)) {
+      auto& event = input.event_;
+
+      switch (event.type) {
+        case SDL_QUIT:
+          return true;
+        case SDL_JOYDEVICEADDED:
+        case SDL_CONTROLLERDEVICEADDED:
+        case SDL_JOYDEVICEREMOVED:
+        case SDL_CONTROLLERDEVICEREMOVED:
+          tetrion_->HandleGameControllerEvents(event);
           break;
         default:
-          tetrion_->GameControl(control);
-          active_control = control;
+          if (InputCapture::IsInput(event) && HandleInput(input, auto_repeat)) {
+            return true;
+          }
           break;
       }
-      if (kAutoRepeatControls.count(active_control) && (time_in_ms() - time_since_last_auto_repeat) >= auto_repeat_threshold) {
-        function_to_repeat();
-        auto_repeat_threshold = (0 == repeat_count) ? kAutoRepeatInitialDelay : kAutoRepeatSubsequentDelay;
-        repeat_count++;
-        time_since_last_auto_repeat = time_in_ms();
+    }
+    Repeat(auto_repeat);
+
+    return false;
+  }
+
+  void Play() {
+    DeltaTimer delta_timer;
+    AutoRepeat auto_repeat(Tetrion::Controls::None, Tetrion::Controls::SoftDrop, kDelayedAutoShift, kAutoRepeatRate, kSoftDropFactor);
+
+    // Input is polled again after the simulation step so that a key pressed meanwhile shows in this frame
+    while (!PollEvents(auto_repeat)) {
+      const auto delta_time = delta_timer.GetDelta();
+
+      tetrion_->Update(delta_time);
+      if (PollEvents(auto_repeat)) {
+        break;
       }
-      tetrion_->Update(delta_timer.GetDelta());
+      tetrion_->Render(delta_time);
     }
   }
 
  private:
   std::shared_ptr<Tetrion> tetrion_ = nullptr;
+  std::shared_ptr<InputCapture> input_capture_ = nullptr;
 };
 
 int main(int, char *[]) {
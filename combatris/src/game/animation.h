@@ -102,10 +102,8 @@ class LinesClearedAnimation final : public Animation {
 
     for (const auto& line : lines_) {
       const auto y = row_to_pixel_adjusted(line.row_) + y_;
-      const auto& minos = line.minos_;
-
       for (int col = kMatrixFirstCol; col < kMatrixLastCol; ++col) {
-        const auto& tetromino = GetAsset().GetTetromino(static_cast<Tetromino::Type>(minos[col]));
+        const auto& tetromino = GetAsset().GetTetromino(static_cast<Tetromino::Type>(line.mino(col)));
 
         tetromino->Render(col_to_pixel_adjusted(col), static_cast<int>(y));
       }
@@ -240,7 +238,7 @@ class SplashScreenAnimation final : public Animation {
   SplashScreenAnimation(SDL_Renderer *renderer, const std::shared_ptr<CombatrisMenu>& menu, const std::shared_ptr<Assets>& assets)
       : Animation(renderer, assets), menu_view_(renderer, { kMatrixStartX, 0, kMatrixWidth, kMenuHeight }, assets->fonts(), menu, menu.get()) {
 
-    texture_1_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_1_.width()), kMatrixStartY + 100);
+    texture_1_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_1_.width()), kMatrixStartY + 40);
     menu_view_.SetY(texture_1_.y() + texture_1_.height() + 25);
     texture_2_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_2_.width()), texture_1_.y() + kMenuHeight);
 
@@ -269,7 +267,7 @@ class GameOverAnimation final : public Animation {
         menu_view_(renderer, { kMatrixStartX, 0, kMatrixWidth, kMenuHeight }, assets->fonts(), menu, menu.get()), text_(text) {
 
     texture_1_ = Texture(*this, GetAsset().GetFont(Normal55), text, Color::White);
-    texture_1_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_1_.width()), kMatrixStartY + 100);
+    texture_1_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_1_.width()), kMatrixStartY + 40);
     menu_view_.SetY(texture_1_.y() + texture_1_.height() + 25);
     texture_2_.SetXY(kMatrixStartX + utility::Center(kMatrixWidth, texture_2_.width()), texture_1_.y() + kMenuHeight);
 
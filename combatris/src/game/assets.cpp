@@ -14,10 +14,7 @@ void DeleteTexture(SDL_Texture* texture) {
   }
 }
 
-SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, Color transparent_color = Color::None) {
-  if (SDL_WasInit(SDL_INIT_EVERYTHING) == 0 || nullptr == renderer) {
-    return nullptr;
-  }
+SDL_Surface* LoadSurface(const std::string& name) {
   auto full_path =  ::kAssetFolder + "art/" + name;
   auto surface = SDL_LoadBMP(full_path.c_str());
 
@@ -25,6 +22,16 @@ SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, Color
     std::cout << "Failed to load surface " << full_path << " error : " << SDL_GetError() << std::endl;
     exit(-1);
   }
+
+  return surface;
+}
+
+SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, Color transparent_color = Color::None) {
+  if (SDL_WasInit(SDL_INIT_EVERYTHING) == 0 || nullptr == renderer) {
+    return nullptr;
+  }
+  auto surface = LoadSurface(name);
+
   if (Color::Transparent == transparent_color) {
     const auto c = GetColor(transparent_color);
 
@@ -42,12 +49,12 @@ SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, int i,
 }
 
 struct TetrominoAssetData {
-  TetrominoAssetData(Tetromino::Type type, Color color, const std::vector<TetrominoRotationData>& rotations, const std::string& image_name) :
+  TetrominoAssetData(Tetromino::Type type, Color color, const TetrominoRotations& rotations, const std::string& image_name) :
       type_(type), color_(GetColor(color)), rotations_(rotations), image_name_(image_name) {}
 
   Tetromino::Type type_;
   SDL_Color color_;
-  std::vector<TetrominoRotationData> rotations_;
+  TetrominoRotations rotations_;
   std::string image_name_;
 };
 
@@ -77,6 +84,36 @@ std::vector<TextureAssetData> kTextures {
   { "Circle.bmp", Color::Transparent }
 };
 
+// All minos side by side in one texture, so the matrix can be drawn without switching texture
+SDL_Texture* CreateMinoAtlas(SDL_Renderer *renderer) {
+  if (SDL_WasInit(SDL_INIT_EVERYTHING) == 0 || nullptr == renderer) {
+    return nullptr;
+  }
+  auto atlas = SDL_CreateRGBSurfaceWithFormat(0, kMinoAtlasCells * kMinoWidth, kMinoHeight, 32, SDL_PIXELFORMAT_RGBA8888);
+
+  if (nullptr == atlas) {
+    std::cout << "Failed to create mino atlas error : " << SDL_GetError() << std::endl;
+    exit(-1);
+  }
+  for (const auto& data : kTetrominoAssetData) {
+    auto surface = LoadSurface(data.image_name_);
+    auto rc = MinoAtlasRect(static_cast<int>(data.type_));
+
+    SDL_BlitScaled(surface, nullptr, atlas, &rc);
+    SDL_FreeSurface(surface);
+  }
+  const auto white_rc = MinoAtlasRect(kMinoAtlasWhiteID);
+
+  SDL_FillRect(atlas, &white_rc, SDL_MapRGB(atlas->format, 255, 255, 255));
+
+  auto texture = SDL_CreateTextureFromSurface(renderer, atlas);
+
+  SDL_FreeSurface(atlas);
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+
+  return texture;
+}
+
 } // namespace
 
 Assets::Assets(SDL_Renderer *renderer) : fonts_(std::make_shared<Fonts>()) {
@@ -86,6 +123,7 @@ Assets::Assets(SDL_Renderer *renderer) : fonts_(std::make_shared<Fonts>()) {
         std::shared_ptr<SDL_Texture>(LoadTexture(renderer, data.image_name_), DeleteTexture)));
     alpha_textures_.push_back(std::shared_ptr<SDL_Texture>(LoadTexture(renderer, data.image_name_), DeleteTexture));
   }
+  mino_atlas_ = std::shared_ptr<SDL_Texture>(CreateMinoAtlas(renderer), DeleteTexture);
   std::transform(kTextures.begin(), kTextures.end(), std::back_inserter(textures_),
       [&renderer](const auto& d) { return std::shared_ptr<SDL_Texture>(LoadTexture(renderer, d.name_, d.transparent_color_), DeleteTexture); });
   for (int i = 1; i <=24; ++i) {
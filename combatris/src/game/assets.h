@@ -35,6 +35,8 @@ class Assets final {
 
   const std::vector<std::shared_ptr<const Tetromino>>& GetTetrominos() const { return tetrominos_; }
 
+  std::shared_ptr<SDL_Texture> GetMinoAtlas() const { return mino_atlas_; }
+
   std::shared_ptr<SDL_Texture> GetAlphaTextures(Tetromino::Type type) const { return alpha_textures_.at(static_cast<int64_t>(type) - 1); }
 
   std::vector<std::shared_ptr<SDL_Texture>> GetHourGlassTextures() const { return hourglass_textures_; }
@@ -44,6 +46,7 @@ class Assets final {
 
   std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
   std::vector<std::shared_ptr<SDL_Texture>> textures_;
+  std::shared_ptr<SDL_Texture> mino_atlas_;
   std::vector<std::shared_ptr<SDL_Texture>> alpha_textures_;
   std::vector<std::shared_ptr<SDL_Texture>> hourglass_textures_;
   std::shared_ptr<utility::Fonts> fonts_;
@@ -0,0 +1,447 @@
+#pragma once
+
+#include "game/tetromino.h"
+#include "game/row_scan.h"
+#include "utility/random.h"
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+
+// Row of a board wider than a machine word, bit n is bit n % 32 of word n / 32
+template <int Words>
+struct WideRow {
+  static_assert(Words >= 2);
+
+  constexpr WideRow() = default;
+
+  constexpr explicit WideRow(uint64_t value) {
+    words_[0] = static_cast<uint32_t>(value);
+    words_[1] = static_cast<uint32_t>(value >> 32);
+  }
+
+  constexpr WideRow operator<<(int shift) const {
+    WideRow row;
+    const auto word_shift = shift / 32;
+    const auto bit_shift = shift % 32;
+
+    for (int i = Words - 1; i >= word_shift; --i) {
+      row.words_[i] = words_[i - word_shift] << bit_shift;
+      if (bit_shift != 0 && i - word_shift - 1 >= 0) {
+        row.words_[i] |= words_[i - word_shift - 1] >> (32 - bit_shift);
+      }
+    }
+    return row;
+  }
+
+  constexpr WideRow operator~() const {
+    WideRow row;
+
+    for (int i = 0; i < Words; ++i) {
+      row.words_[i] = ~words_[i];
+    }
+    return row;
+  }
+
+  constexpr WideRow& operator&=(const WideRow& rhs) {
+    for (int i = 0; i < Words; ++i) {
+      words_[i] &= rhs.words_[i];
+    }
+    return *this;
+  }
+
+  constexpr WideRow& operator|=(const WideRow& rhs) {
+    for (int i = 0; i < Words; ++i) {
+      words_[i] |= rhs.words_[i];
+    }
+    return *this;
+  }
+
+  constexpr WideRow operator&(const WideRow& rhs) const { return WideRow(*this) &= rhs; }
+
+  constexpr WideRow operator|(const WideRow& rhs) const { return WideRow(*this) |= rhs; }
+
+  constexpr bool operator==(const WideRow& rhs) const { return words_ == rhs.words_; }
+
+  std::array<uint32_t, Words> words_ {};
+};
+
+// One bit per column of a row, borders included. Rows wider than 32 columns are split in 32-bit words so
+// the row scan kernel can run once per word.
+template <int Cols>
+using BoardRowType = std::conditional_t<(Cols <= 32), uint32_t, WideRow<(Cols + 31) / 32>>;
+
+template <typename Row>
+constexpr Row MakeRowMask(int first_col, int last_col) {
+  Row row(0);
+
+  for (int col = first_col; col < last_col; ++col) {
+    row |= Row(1) << col;
+  }
+  return row;
+}
+
+// Color words of a row, one nibble per column
+template <int Cols>
+using BoardColorRowType = std::array<uint64_t, (Cols + 15) / 16>;
+
+template <int Cols>
+constexpr BoardColorRowType<Cols> FillColors(BoardColorRowType<Cols> colors, int first_col, int last_col, int id) {
+  for (int col = first_col; col < last_col; ++col) {
+    const auto shift = (col % 16) * 4;
+
+    colors[col / 16] = (colors[col / 16] & ~(uint64_t(0xF) << shift)) | (static_cast<uint64_t>(id) << shift);
+  }
+  return colors;
+}
+
+// Bitboard representation of the matrix. Every row is a machine word (a few for wide boards) with one bit
+// per column, the columns outside the playable area are always set so the border is part of every collision
+// test. The tetromino id of every cell is kept in a separate color plane (one nibble per column) which is
+// only read when rendering or when the content of a line is needed.
+// Rows are reached through a row index, line clears and garbage rises rotate the index and never copy rows.
+//
+// The geometry is given at compile time, VisibleRows x VisibleCols is the playable area and BufferRows
+// the vanish zone above it. The row word is picked from the width of the board.
+template <int VisibleRows, int VisibleCols, int BufferRows>
+class BasicBoard final {
+ public:
+  static constexpr int kBorderCols = 2;
+  static constexpr int kFloorRows = TetrominoRotationData::kShapeSize;
+  static constexpr int kFirstRow = BufferRows;
+  static constexpr int kLastRow = BufferRows + VisibleRows;
+  static constexpr int kFirstCol = kBorderCols;
+  static constexpr int kLastCol = kBorderCols + VisibleCols;
+  static constexpr int kRows = kLastRow + kFloorRows;
+  static constexpr int kCols = VisibleCols + kBorderCols * 2;
+
+  static_assert(kLastRow <= 64, "The row scan covers at most 64 rows");
+  static_assert(VisibleCols < 256, "Filled cells per row are counted in a byte");
+
+  using Row = BoardRowType<kCols>;
+  using ColorRow = BoardColorRowType<kCols>;
+
+  static constexpr Row kPlayableMask = MakeRowMask<Row>(kFirstCol, kLastCol);
+  static constexpr Row kEmptyRow = ~kPlayableMask;
+  static constexpr Row kFullRow = ~Row(0);
+
+  BasicBoard() { Reset(); }
+
+  void Reset() {
+    std::iota(index_.begin(), index_.end(), 0);
+    std::fill(rows_.begin(), std::next(rows_.begin(), kLastRow), kEmptyRow);
+    std::fill(colors_.begin(), std::next(colors_.begin(), kLastRow), kEmptyColorRow);
+    std::fill(std::next(rows_.begin(), kLastRow), rows_.end(), kFullRow);
+    std::fill(std::next(colors_.begin(), kLastRow), colors_.end(), kFloorColorRow);
+    filled_.fill(0);
+    total_filled_ = 0;
+    highest_row_ = kLastRow;
+    row_hash_.fill(0);
+    hash_ = 0;
+  }
+
+  inline Row row(int r) const { return rows_[index_[r]]; }
+
+  inline int at(int r, int col) const { return static_cast<int>((colors_[index_[r]][col / 16] >> ((col % 16) * 4)) & 0xF); }
+
+  void Set(int r, int col, int id) {
+    const auto slot = index_[r];
+    auto& colors = colors_[slot][col / 16];
+    const auto shift = (col % 16) * 4;
+
+    hash_ ^= RowKey(row_hash_[slot], r);
+    row_hash_[slot] ^= CellKey(col, at(r, col)) ^ CellKey(col, id);
+    hash_ ^= RowKey(row_hash_[slot], r);
+    colors = (colors & ~(uint64_t(0xF) << shift)) | (static_cast<uint64_t>(id) << shift);
+    if (kEmptyID == id || kBombID == id) {
+      rows_[slot] &= ~(Row(1) << col);
+    } else {
+      rows_[slot] |= Row(1) << col;
+    }
+    UpdateFilled(r);
+  }
+
+  inline const ColorRow& colors(int r) const { return colors_[index_[r]]; }
+
+  // Occupancy, kept up to date by every change to the board
+  inline int filled(int r) const { return filled_[index_[r]]; }
+
+  inline int total_filled() const { return total_filled_; }
+
+  // The first row with a filled cell, kLastRow when the board is empty
+  inline int highest_row() const { return highest_row_; }
+
+  // Zobrist hash of the cells, kept up to date by every change to the board. The keys are derived from
+  // fixed constants so the hash is the same on every platform.
+  inline uint64_t hash() const { return hash_; }
+
+  uint64_t ComputeHash() const {
+    uint64_t hash = 0;
+
+    for (int r = 0; r < kLastRow; ++r) {
+      hash ^= RowKey(HashColors(colors(r)), r);
+    }
+    return hash;
+  }
+
+  // The color plane in row order is the whole state of the board, the bitboard and the counters are rebuilt from it
+  using Colors = std::array<ColorRow, kLastRow>;
+
+  void Capture(Colors& colors) const {
+    for (int r = 0; r < kLastRow; ++r) {
+      colors[r] = colors_[index_[r]];
+    }
+  }
+
+  void Restore(const Colors& colors) {
+    std::iota(index_.begin(), index_.end(), 0);
+    total_filled_ = 0;
+    highest_row_ = kLastRow;
+    hash_ = 0;
+    for (int r = kLastRow - 1; r >= 0; --r) {
+      colors_[r] = colors[r];
+      rows_[r] = RowFromColors(colors[r]);
+      row_hash_[r] = HashColors(colors[r]);
+      hash_ ^= RowKey(row_hash_[r], r);
+      filled_[r] = static_cast<uint8_t>(CountFilled(rows_[r]));
+      total_filled_ += filled_[r];
+      if (filled_[r] > 0) {
+        highest_row_ = r;
+      }
+    }
+  }
+
+  void CopyTo(std::vector<std::vector<int>>& matrix) const {
+    matrix.resize(kRows);
+    for (int r = 0; r < kRows; ++r) {
+      matrix[r].resize(kCols);
+      for (int col = 0; col < kCols; ++col) {
+        matrix[r][col] = at(r, col);
+      }
+    }
+  }
+
+  bool IsValid(const Position& pos, const TetrominoRotationData& rotation_data) const {
+    // Every shape fits in kShapeSize rows, and a position below kRows - kShapeSize is always inside the floor
+    if (pos.col() < 0 || pos.row() < 0 || pos.col() + rotation_data.last_col_ >= kCols || pos.row() > kRows - kFloorRows) {
+      return false;
+    }
+    const auto& masks = rotation_data.masks_;
+    const auto* index = &index_[pos.row()];
+    const auto col = pos.col();
+
+    return Row(0) == (((Row(masks[0]) << col) & rows_[index[0]]) | ((Row(masks[1]) << col) & rows_[index[1]]) |
+                      ((Row(masks[2]) << col) & rows_[index[2]]) | ((Row(masks[3]) << col) & rows_[index[3]]));
+  }
+
+  void Insert(const Position& pos, const TetrominoRotationData& rotation_data) {
+    for (int r = rotation_data.first_row_; r <= rotation_data.last_row_; ++r) {
+      for (int mask = rotation_data.masks_[r], col = 0; mask != 0; mask >>= 1, ++col) {
+        if (mask & 1) {
+          Set(pos.row() + r, pos.col() + col, rotation_data.id_);
+        }
+      }
+    }
+  }
+
+  // Full, empty and solid rows of the matrix (the floor is not part of the scan)
+  RowScan Scan() const {
+    const auto solid_shift = (kFirstCol % 16) * 4;
+    std::array<uint64_t, kLastRow> colors;
+
+    for (int r = 0; r < kLastRow; ++r) {
+      colors[r] = colors_[index_[r]][kFirstCol / 16];
+    }
+    if constexpr (std::is_same_v<Row, uint32_t>) {
+      std::array<Row, kLastRow> rows;
+
+      for (int r = 0; r < kLastRow; ++r) {
+        rows[r] = row(r);
+      }
+      return ScanRows(rows.data(), colors.data(), kLastRow, kFullRow, kEmptyRow, solid_shift);
+    } else {
+      // A row is full or empty when every one of its words is
+      RowScan scan { ~uint64_t(0), ~uint64_t(0), 0 };
+      std::array<uint32_t, kLastRow> words;
+
+      for (size_t w = 0; w < kFullRow.words_.size(); ++w) {
+        for (int r = 0; r < kLastRow; ++r) {
+          words[r] = row(r).words_[w];
+        }
+        const auto word_scan = ScanRows(words.data(), colors.data(), kLastRow, kFullRow.words_[w], kEmptyRow.words_[w], solid_shift);
+
+        scan.full_ &= word_scan.full_;
+        scan.empty_ &= word_scan.empty_;
+        scan.solid_ = word_scan.solid_;
+      }
+      return scan;
+    }
+  }
+
+  inline bool IsFull(int r) const { return kFullRow == row(r); }
+
+  inline bool IsEmpty(int r) const { return kEmptyRow == row(r); }
+
+  // Removes row r and moves every row above it one step down
+  void MoveLineDown(int r) {
+    // Only the rows between the top of the stack and r change place
+    HashRows(highest_row_, r + 1);
+    std::rotate(index_.begin(), std::next(index_.begin(), r), std::next(index_.begin(), r + 1));
+    rows_[index_[0]] = kEmptyRow;
+    colors_[index_[0]] = kEmptyColorRow;
+    row_hash_[index_[0]] = 0;
+    HashRows(highest_row_, r + 1);
+    total_filled_ -= filled_[index_[0]];
+    filled_[index_[0]] = 0;
+    if (0 == total_filled_) {
+      highest_row_ = kLastRow;
+    } else if (highest_row_ < r) {
+      highest_row_++;
+    } else if (highest_row_ == r) {
+      // The removed row was the top of the stack, the rows below it are unchanged
+      highest_row_ = FindHighestRow(r + 1);
+    }
+  }
+
+  // Moves the stack up to make room for solid lines, returns 0 if the stack would be pushed out of the matrix
+  int MoveLinesUp(int lines) {
+    const int first_non_empty_row = std::min(highest_row_, kLastRow - 1);
+
+    if (first_non_empty_row - lines <= 0)  {
+      return 0;
+    }
+    // The rows rotated in at the bottom are empty and are filled by InsertSolidLine
+    HashRows(highest_row_, kLastRow);
+    std::rotate(index_.begin(), std::next(index_.begin(), lines), std::next(index_.begin(), kLastRow));
+    if (highest_row_ < kLastRow) {
+      highest_row_ -= lines;
+    }
+    HashRows(highest_row_, kLastRow);
+
+    return lines;
+  }
+
+  void InsertSolidLine(int r, int hole_col) {
+    const auto slot = index_[r];
+
+    hash_ ^= RowKey(row_hash_[slot], r) ^ RowKey(kSolidRowHash, r);
+    row_hash_[slot] = kSolidRowHash;
+    rows_[slot] = kFullRow & ~(Row(1) << hole_col);
+    colors_[slot] = kSolidColorRow;
+    Set(r, hole_col, kBombID);
+  }
+
+ private:
+  using CellKeys = std::array<uint64_t, kCols * 16>;
+
+  // An empty cell has no key, so an empty row hashes to 0 and is left out of the board hash
+  static constexpr CellKeys MakeCellKeys() {
+    CellKeys keys {};
+
+    for (int col = kFirstCol; col < kLastCol; ++col) {
+      for (int id = kEmptyID + 1; id < 16; ++id) {
+        keys[col * 16 + id] = utility::SplitMix64::Mix(static_cast<uint64_t>(col * 16 + id) * 0x9E3779B97F4A7C15);
+      }
+    }
+    return keys;
+  }
+
+  static constexpr CellKeys kCellKeys = MakeCellKeys();
+
+  static inline uint64_t CellKey(int col, int id) { return kCellKeys[col * 16 + id]; }
+
+  // The hash of a row does not depend on where the row is, it is mixed with the row number when it is
+  // added to the board hash. Moving rows only costs a mix per moved row that isn't empty.
+  static inline uint64_t RowKey(uint64_t row_hash, int r) {
+    return (0 == row_hash) ? 0 : utility::SplitMix64::Mix(row_hash + static_cast<uint64_t>(r + 1) * 0xD1B54A32D192ED03);
+  }
+
+  static constexpr uint64_t HashColors(const ColorRow& colors) {
+    uint64_t hash = 0;
+
+    for (int col = kFirstCol; col < kLastCol; ++col) {
+      hash ^= kCellKeys[col * 16 + static_cast<int>((colors[col / 16] >> ((col % 16) * 4)) & 0xF)];
+    }
+    return hash;
+  }
+
+  void HashRows(int first_row, int last_row) {
+    for (int r = first_row; r < last_row; ++r) {
+      hash_ ^= RowKey(row_hash_[index_[r]], r);
+    }
+  }
+
+  static Row RowFromColors(const ColorRow& colors) {
+    Row row(0);
+
+    for (int col = 0; col < kCols; ++col) {
+      const auto id = static_cast<int>((colors[col / 16] >> ((col % 16) * 4)) & 0xF);
+
+      if (kEmptyID != id && kBombID != id) {
+        row |= Row(1) << col;
+      }
+    }
+    return row;
+  }
+
+  static int CountFilled(const Row& row) {
+    if constexpr (std::is_same_v<Row, uint32_t>) {
+      return std::popcount(row & kPlayableMask);
+    } else {
+      int count = 0;
+
+      for (auto word : (row & kPlayableMask).words_) {
+        count += std::popcount(word);
+      }
+      return count;
+    }
+  }
+
+  void UpdateFilled(int r) {
+    const auto slot = index_[r];
+    const auto count = CountFilled(rows_[slot]);
+
+    total_filled_ += count - filled_[slot];
+    filled_[slot] = static_cast<uint8_t>(count);
+    if (count > 0 && r < highest_row_) {
+      highest_row_ = r;
+    } else if (0 == count && r == highest_row_) {
+      highest_row_ = FindHighestRow(r + 1);
+    }
+  }
+
+  int FindHighestRow(int first_row) const {
+    for (int r = first_row; r < kLastRow; ++r) {
+      if (filled_[index_[r]] > 0) {
+        return r;
+      }
+    }
+    return kLastRow;
+  }
+
+  static constexpr ColorRow kEmptyColorRow = FillColors<kCols>(FillColors<kCols>({}, 0, kFirstCol, kBorderID), kLastCol, kCols, kBorderID);
+  static constexpr ColorRow kSolidColorRow = FillColors<kCols>(kEmptyColorRow, kFirstCol, kLastCol, kSolidID);
+  static constexpr ColorRow kFloorColorRow = FillColors<kCols>({}, 0, kCols, kBorderID);
+  static constexpr uint64_t kSolidRowHash = HashColors(kSolidColorRow);
+
+  // Maps a matrix row to its slot in rows_ and colors_, the floor rows are never moved
+  std::array<uint8_t, kRows> index_;
+  std::array<Row, kRows> rows_;
+  std::array<ColorRow, kRows> colors_;
+  // Filled cells per slot, same slot as rows_
+  std::array<uint8_t, kRows> filled_;
+  int total_filled_;
+  int highest_row_;
+  // Hash of the cells of every slot, same slot as rows_
+  std::array<uint64_t, kRows> row_hash_;
+  uint64_t hash_;
+};
+
+// The standard 10 x 20 matrix with a 20 row vanish zone
+using Board = BasicBoard<kVisibleRows, kVisibleCols, kMatrixFirstRow>;
+
+static_assert(Board::kFirstCol == kMatrixFirstCol && Board::kLastRow == kMatrixLastRow);
@@ -52,11 +52,22 @@ Campaign::Campaign(SDL_Window* window, SDL_Renderer* renderer, Events& events, c
   AddListener(knockout_.get());
   multi_player_ = std::make_shared<MultiPlayer>(renderer_, matrix_, events_, assets_);
   AddListener(multi_player_.get());
+  AddListener(matrix_.get());
   AddListener(this);
 }
 
 void Campaign::Update(const Event& event) {
-  if (!IsIn(event, { Event::Type::MenuSetModeAndCampaign, Event::Type::HideMultiPlayerPanel })) {
+  if (!IsSubscribed(event.type())) {
+    return;
+  }
+  if (event.Is(Event::Type::MenuSetRotationSystem)) {
+    rotation_system_ = static_cast<RotationSystemType>(event.value1_);
+    ApplyRotationSystem();
+    return;
+  }
+  if (event.Is(Event::Type::MenuSetRandomizer)) {
+    randomizer_ = static_cast<RandomizerType>(event.value1_);
+    ApplyRandomizer();
     return;
   }
   if (event.Is(Event::Type::HideMultiPlayerPanel)) {
@@ -80,6 +91,8 @@ void Campaign::Update(const Event& event) {
       default:
         break;
     }
+    ApplyRotationSystem();
+    ApplyRandomizer();
   }
   if (ModeType::MultiPlayer == mode_type_) {
     title = "Multiplayer - " + title + " (" + multi_player_->our_host_name() + " )";
@@ -95,9 +108,41 @@ void Campaign::Render(double delta_time) {
   std::for_each(panes_.begin(), panes_.end(), [delta_time](const auto& pane) { pane->Render(delta_time); });
 }
 
-Event Campaign::PreprocessEvent(const Event& event) {
-  std::for_each(event_listeners_.begin(), event_listeners_.end(), [&event](const auto& r) { r->Update(event); });
-  return event;
+void Campaign::PreprocessEvent(const Event& event) {
+  if (rebuild_subscriptions_) {
+    BuildSubscriptions();
+  }
+  const auto type = static_cast<size_t>(event.type());
+  const auto start = utility::time_in_ns();
+
+  std::for_each(subscribers_[type].begin(), subscribers_[type].end(), [&event](const auto& r) { r->Update(event); });
+  event_statistics_[type].count_++;
+  event_statistics_[type].time_ += utility::time_in_ns() - start;
+}
+
+void Campaign::BuildSubscriptions() {
+  std::for_each(subscribers_.begin(), subscribers_.end(), [](auto& subscribers) { subscribers.clear(); });
+  for (auto listener : event_listeners_) {
+    const auto types = listener->Subscriptions();
+
+    for (size_t type = 0; type < Event::kNumberOfTypes; ++type) {
+      if (types.empty() || std::find(types.begin(), types.end(), static_cast<Event::Type>(type)) != types.end()) {
+        subscribers_[type].push_back(listener);
+      }
+    }
+  }
+  rebuild_subscriptions_ = false;
+}
+
+void Campaign::ReportEventStatistics(std::ostream& os) const {
+  for (size_t type = 0; type < Event::kNumberOfTypes; ++type) {
+    const auto& statistics = event_statistics_[type];
+
+    if (statistics.count_ > 0) {
+      os << "Event " << type << ": " << subscribers_[type].size() << " subscribers, " << statistics.count_ << " dispatched, "
+         << statistics.time_ / 1000 << " us" << std::endl;
+    }
+  }
 }
 
 void Campaign::SetupCampaign(CampaignType type) {
@@ -147,5 +192,9 @@ void Campaign::SetupCampaign(CampaignType type) {
     default:
       break;
   }
+  ApplyRotationSystem();
+  ApplyRandomizer();
+  // Rebuilt before the next event, SetupCampaign runs while an event is dispatched
+  rebuild_subscriptions_ = true;
   events_.Push(Event::Type::SetCampaign, campaign_type_);
 }
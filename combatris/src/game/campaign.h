@@ -15,16 +15,37 @@
 
 class Campaign : public EventListener {
  public:
+  struct EventStatistics {
+    uint64_t count_ = 0;
+    int64_t time_ = 0; // nanoseconds spent in the subscribers
+  };
+
   Campaign(SDL_Window* window, SDL_Renderer* renderer, Events& events, const std::shared_ptr<Assets>& assets,
            const std::shared_ptr<Matrix>& matrix);
 
   inline operator CampaignType() const { return campaign_type_; }
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::MenuSetModeAndCampaign, Event::Type::HideMultiPlayerPanel, Event::Type::MenuSetRotationSystem,
+    Event::Type::MenuSetRandomizer
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override;
 
   void Render(double delta_time);
 
-  Event PreprocessEvent(const Event& event);
+  // Hands the event to the listeners that subscribe to its type
+  void PreprocessEvent(const Event& event);
+
+  void ReportEventStatistics(std::ostream& os) const;
+
+  // Used by test suit
+  inline const std::vector<EventListener*>& event_listeners() const { return event_listeners_; }
+
+  // Used by test suit
+  inline const std::vector<EventListener*>& subscribers(Event::Type type) const { return subscribers_.at(static_cast<size_t>(type)); }
 
   void Reset() {
     std::for_each(panes_.begin(), panes_.end(), [](const auto& r) { r->Reset(); });
@@ -58,6 +79,18 @@ class Campaign : public EventListener {
 
   void SetupCampaign(CampaignType type);
 
+  void BuildSubscriptions();
+
+  // Peers only share the seed, so every peer in a multiplayer game draws from the 7-bag
+  void ApplyRandomizer() {
+    tetromino_generator_->SetRandomizer((ModeType::MultiPlayer == mode_type_) ? RandomizerType::SevenBag : randomizer_);
+  }
+
+  // Every peer in a multiplayer game plays by the same rules, SRS
+  void ApplyRotationSystem() {
+    tetromino_generator_->SetRotationSystem((ModeType::MultiPlayer == mode_type_) ? RotationSystemType::SRS : rotation_system_);
+  }
+
  private:
   SDL_Window* window_;
   SDL_Renderer* renderer_;
@@ -81,7 +114,12 @@ class Campaign : public EventListener {
   std::shared_ptr<MultiPlayer> multi_player_;
   std::vector<PaneInterface*> panes_;
   std::vector<EventListener*> event_listeners_;
+  std::array<std::vector<EventListener*>, Event::kNumberOfTypes> subscribers_;
+  std::array<EventStatistics, Event::kNumberOfTypes> event_statistics_;
+  bool rebuild_subscriptions_ = true;
   ModeType mode_type_ = ModeType::None;
   CampaignType campaign_type_ = CampaignType::None;
+  RotationSystemType rotation_system_ = RotationSystemType::SRS;
+  RandomizerType randomizer_ = RandomizerType::SevenBag;
   bool is_multiplayer_panel_hidden_ = false;
 };
@@ -10,11 +10,20 @@ class CombatrisMenu : public utility::MenuModel, public utility::MenuAction, pub
   const size_t kSelectInput = 3;
   const size_t kSelectCampaign = 5;
   const size_t kSelectLevel = 7;
+  const size_t kSelectRotationSystem = 9;
+  const size_t kSelectRandomizer = 11;
 
   const std::vector<std::string> kModes = { "Single Player", "Multi Player" };
   const std::vector<std::string> kDefaultInput =  { "Keyboard" };
   const std::vector<std::string> kSinglePlayerCampaigns = { "Combatris", "Marathon", "Sprint", "Ultra", "Royal" };
   const std::vector<std::string> kMultiPlayerCampaigns =  {"Combatris", "Marathon", "Sprint", "Ultra", "Royal", "Battle"};
+  // In the order of RotationSystemType
+  const std::vector<std::string> kRotationSystems = { "SRS", "SRS+", "ARS" };
+  const std::vector<std::string> kMultiPlayerRotationSystems = { "SRS" };
+  // In the order of RandomizerType
+  const std::vector<std::string> kRandomizers = { "7-Bag", "14-Bag", "History", "Random" };
+  // Peers share the seed of the piece stream, not the randomizer
+  const std::vector<std::string> kMultiPlayerRandomizers = { "7-Bag" };
 
   CombatrisMenu(Events& events, std::shared_ptr<utility::GameController> game_controller) :
       MenuModel(), events_(events), game_controller_(game_controller) {
@@ -28,10 +37,14 @@ class CombatrisMenu : public utility::MenuModel, public utility::MenuAction, pub
 
     std::vector<std::string> level_sub_menu;
 
-    for (auto l = 0; l < kMaxNumberOfLevels; ++l) {
+    for (auto l = 0; l < kMaxNumberOfLevels + kNumberOfMasterLevels; ++l) {
       level_sub_menu.push_back(std::to_string(l + 1));
     }
     MenuModel::Add(MenuItemType::SubMenu, level_sub_menu);
+    MenuModel::Add(MenuItemType::Name, "Rotation:");
+    MenuModel::Add(MenuItemType::SubMenu, kRotationSystems);
+    MenuModel::Add(MenuItemType::Name, "Randomizer:");
+    MenuModel::Add(MenuItemType::SubMenu, kRandomizers);
     game_controller_->AddCallback(this);
   }
 
@@ -45,7 +58,11 @@ class CombatrisMenu : public utility::MenuModel, public utility::MenuAction, pub
       mode_ = static_cast<ModeType>(sub_item + 1);
       campaign_ = CampaignType::Combatris;
       Set(kSelectCampaign, (sub_item == 0) ? kSinglePlayerCampaigns : kMultiPlayerCampaigns);
+      Set(kSelectRotationSystem, (sub_item == 0) ? kRotationSystems : kMultiPlayerRotationSystems);
+      Set(kSelectRandomizer, (sub_item == 0) ? kRandomizers : kMultiPlayerRandomizers);
       events_.Push(Event::Type::MenuSetModeAndCampaign, mode_, campaign_);
+      events_.Push(Event::Type::MenuSetRotationSystem, 0);
+      events_.Push(Event::Type::MenuSetRandomizer, 0);
     } else if (kSelectInput == item) {
       game_controller_->Detach(current_game_controller_);
       current_game_controller_ = map_item_to_controller.at(sub_item);
@@ -55,6 +72,10 @@ class CombatrisMenu : public utility::MenuModel, public utility::MenuAction, pub
       events_.Push(Event::Type::MenuSetModeAndCampaign, mode_, campaign_);
     } else if (kSelectLevel == item) {
       events_.Push(Event::Type::SetStartLevel, static_cast<int>(sub_item + 1));
+    } else if (kSelectRotationSystem == item) {
+      events_.Push(Event::Type::MenuSetRotationSystem, static_cast<int>(sub_item));
+    } else if (kSelectRandomizer == item) {
+      events_.Push(Event::Type::MenuSetRandomizer, static_cast<int>(sub_item));
     }
   }
 
@@ -1,7 +1,8 @@
 #pragma once
 
-const int kMenuHeight = 430;
+const int kMenuHeight = 590;
 const int kMaxNumberOfLevels = 15;
+const int kNumberOfMasterLevels = 5;
 const int kVisibleRows = 20;
 const int kVisibleCols = 10;
 const int kMatrixFirstRow = 20;
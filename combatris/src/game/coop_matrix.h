@@ -0,0 +1,105 @@
+#pragma once
+
+#include "game/board.h"
+
+#include <bit>
+
+// Engine of the co-op party mode: one wide board where several players have a tetromino in play at the same
+// time. A tetromino only collides with the committed board, tetrominos in play pass through each other.
+template <typename BoardType, int MaxPieces = 8>
+class CoopMatrix final {
+ public:
+  static constexpr int kNoPiece = -1;
+
+  CoopMatrix() = default;
+
+  CoopMatrix(const CoopMatrix&) = delete;
+
+  void Reset() {
+    board_.Reset();
+    pieces_.fill(Piece());
+  }
+
+  const BoardType& board() const { return board_; }
+
+  // The committed board with the tetrominos in play on top
+  int at(int row, int col) const {
+    for (const auto& piece : pieces_) {
+      const auto shape_row = row - piece.pos_.row();
+      const auto shape_col = col - piece.pos_.col();
+
+      if (piece.in_play_ && shape_row >= 0 && shape_row < TetrominoRotationData::kShapeSize &&
+          shape_col >= 0 && shape_col < TetrominoRotationData::kShapeSize && ((piece.rotation_data_.masks_[shape_row] >> shape_col) & 1)) {
+        return piece.rotation_data_.id_;
+      }
+    }
+    return board_.at(row, col);
+  }
+
+  // Returns the piece handle, or kNoPiece if every slot is taken or the spawn position is blocked
+  int Spawn(const Position& pos, const TetrominoRotationData& rotation_data) {
+    const auto it = std::find_if(pieces_.begin(), pieces_.end(), [](const auto& piece) { return !piece.in_play_; });
+
+    if (pieces_.end() == it || !board_.IsValid(pos, rotation_data)) {
+      return kNoPiece;
+    }
+    *it = Piece { pos, rotation_data, true };
+
+    return static_cast<int>(std::distance(pieces_.begin(), it));
+  }
+
+  // Moves and rotates are the same thing, the piece is placed at pos with rotation_data if it fits
+  bool Move(int piece, const Position& pos, const TetrominoRotationData& rotation_data) {
+    if (!board_.IsValid(pos, rotation_data)) {
+      return false;
+    }
+    pieces_.at(piece).pos_ = pos;
+    pieces_.at(piece).rotation_data_ = rotation_data;
+
+    return true;
+  }
+
+  // False when the piece overlaps a tetromino committed by another player after it was moved
+  bool IsValid(int piece) const { return board_.IsValid(pieces_.at(piece).pos_, pieces_.at(piece).rotation_data_); }
+
+  bool InPlay(int piece) const { return pieces_.at(piece).in_play_; }
+
+  const Position& position(int piece) const { return pieces_.at(piece).pos_; }
+
+  Position GetDropPosition(int piece) const {
+    const auto& rotation_data = pieces_.at(piece).rotation_data_;
+    Position pos(pieces_.at(piece).pos_);
+
+    while (board_.IsValid(Position(pos.row() + 1, pos.col()), rotation_data)) {
+      pos.inc_row();
+    }
+    return pos;
+  }
+
+  // Drops and locks the piece, returns the cleared rows as a bit mask
+  uint64_t Commit(int piece) {
+    board_.Insert(GetDropPosition(piece), pieces_.at(piece).rotation_data_);
+    Remove(piece);
+
+    const auto visible_rows = ~((uint64_t(1) << BoardType::kFirstRow) - 1);
+    const auto lines_cleared = board_.Scan().full_ & visible_rows;
+
+    // Removing a row only moves the rows above it, clear from the top so the rows below are unchanged
+    for (auto full = lines_cleared; full != 0; full &= full - 1) {
+      board_.MoveLineDown(std::countr_zero(full));
+    }
+    return lines_cleared;
+  }
+
+  void Remove(int piece) { pieces_.at(piece).in_play_ = false; }
+
+ private:
+  struct Piece {
+    Position pos_;
+    TetrominoRotationData rotation_data_;
+    bool in_play_ = false;
+  };
+
+  BoardType board_;
+  std::array<Piece, MaxPieces> pieces_;
+};
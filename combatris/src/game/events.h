@@ -2,25 +2,68 @@
 
 #include "game/coordinates.h"
 #include "game/combatris_types.h"
+#include "utility/ring_buffer.h"
+#include "utility/trace.h"
 
-#include <deque>
+#include <array>
 #include <vector>
+#include <cassert>
+#include <cstdint>
 #include <algorithm>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
 
+// A cleared row, the mino id of every matrix column is packed in one nibble
 struct Line {
-  Line(int row, const std::vector<int>& minos) : row_(row), minos_(minos) {}
+  Line() = default;
 
-  int row_;
-  std::vector<int> minos_;
+  Line(int row, uint64_t minos) : row_(row), minos_(minos) {}
+
+  inline int mino(int col) const { return static_cast<int>((minos_ >> (col * 4)) & 0xF); }
+
+  int row_ = 0;
+  uint64_t minos_ = 0;
 };
 
-using Lines = std::vector<Line>;
+// The rows cleared by a single lock, a tetromino spans at most four rows so they are kept inline
+class Lines final {
+ public:
+  static const int kCapacity = 4;
+
+  Lines() = default;
+
+  void push_back(const Line& line) {
+    assert(size_ < kCapacity);
+    lines_[size_++] = line;
+  }
+
+  inline size_t size() const { return static_cast<size_t>(size_); }
+
+  inline bool empty() const { return 0 == size_; }
+
+  inline const Line& at(size_t i) const {
+    assert(i < size());
+    return lines_[i];
+  }
+
+  inline const Line& operator[](size_t i) const { return lines_[i]; }
+
+  inline const Line* begin() const { return lines_.data(); }
+
+  inline const Line* end() const { return lines_.data() + size_; }
+
+ private:
+  std::array<Line, kCapacity> lines_;
+  int size_ = 0;
+};
 
-enum class TSpinType { None, TSpin, TSpinMini };
-enum class ComboType { None, B2BTSpin, B2BCombatris, Combo };
+enum class TSpinType : uint8_t { None, TSpin, TSpinMini, AllSpin };
+enum class ComboType : uint8_t { None, B2BTSpin, B2BCombatris, Combo };
 
 struct Event {
-  enum class Type {
+  enum class Type : uint8_t {
     None,
     Pause,
     UnPause,
@@ -56,19 +99,23 @@ struct Event {
     BattleKnockedOut,
     BattleYouDidKO,
     BattleNextTetrominoSuccessful,
-    HideMultiPlayerPanel
+    HideMultiPlayerPanel,
+    MenuSetRotationSystem,
+    MenuSetRandomizer
   };
 
-  inline explicit Event(Type type, double time = 0.0) : type_(type), lines_(), delay_(time) {}
+  static constexpr size_t kNumberOfTypes = static_cast<size_t>(Type::MenuSetRandomizer) + 1;
+
+  inline explicit Event(Type type) : type_(type) {}
 
   inline Event(Type type, const Lines& lines_cleared, const Position& pos, TSpinType tspin_type)
-      : type_(type), lines_(lines_cleared), pos_(pos), tspin_type_(tspin_type) {}
+      : type_(type), tspin_type_(tspin_type), pos_(pos), lines_(lines_cleared) {}
 
-  inline Event(Type type, const Lines& lines, int lines_to_clear) : type_(type), lines_(lines), value1_(lines_to_clear) {}
+  inline Event(Type type, const Lines& lines, int lines_to_clear) : type_(type), value1_(lines_to_clear), lines_(lines) {}
 
   inline Event(Type type, int value1, size_t value2) : type_(type), value1_(value1), value2_(value2) {}
 
-  inline Event(Type type, const Lines& lines, const Position& pos, int score, int lines_sent) : type_(type), lines_(lines), pos_(pos), value1_(score), value2_(lines_sent) {}
+  inline Event(Type type, const Lines& lines, const Position& pos, int score, int lines_sent) : type_(type), value1_(score), pos_(pos), lines_(lines), value2_(lines_sent) {}
 
   inline Event(Type type, int value) : type_(type), value1_(value) {}
 
@@ -79,7 +126,7 @@ struct Event {
   inline Event(Type type, CampaignType campaign_type) : type_(type), value2_(ToInt(campaign_type)) {}
 
   inline Event(Type type, const Lines& lines_cleared, TSpinType tspin_type, ComboType combo_type, int combo_counter) :
-      type_(type), lines_(lines_cleared), tspin_type_(tspin_type), combo_type_(combo_type), combo_counter_(combo_counter) {}
+      type_(type), tspin_type_(tspin_type), combo_type_(combo_type), combo_counter_(combo_counter), lines_(lines_cleared) {}
 
   inline operator Event::Type() const { return type_; }
 
@@ -101,33 +148,54 @@ struct Event {
 
   inline int value2_as_int() const { return static_cast<int>(value2_); }
 
+  // Ordered by size to keep the padding down, events are copied in and out of the queue
   Type type_;
-  Lines lines_;
-  Position pos_ = Position(-1, -1);
   TSpinType tspin_type_ = TSpinType::None;
   ComboType combo_type_ = ComboType::None;
   int value1_ = 0;
-  size_t value2_ = 0;
   int combo_counter_ = 0;
-  double delay_ = 0.0;
+  Position pos_ = Position(-1, -1);
+  Lines lines_;
+  size_t value2_ = 0;
 };
 
+static_assert(std::is_trivially_copyable_v<Event> && sizeof(Event) <= 104);
+
 inline bool IsIn(Event::Type type, const std::initializer_list<Event::Type>& list) {
   return std::find(list.begin(), list.end(), type) != list.end();
 }
 
 class EventListener {
  public:
+  using EventTypes = std::span<const Event::Type>;
+
   virtual ~EventListener() noexcept {}
 
+  // The event types Update handles, an empty list gets every event. Listeners keep them in one kSubscriptions
+  // array, the dispatch table is built from it and Update checks it with IsSubscribed.
+  virtual EventTypes Subscriptions() const { return {}; }
+
+  bool IsSubscribed(Event::Type type) const {
+    const auto types = Subscriptions();
+
+    return types.empty() || std::find(types.begin(), types.end(), type) != types.end();
+  }
+
   virtual void Update(const Event& event) = 0;
 };
 
+// Events are handed out in the order they were pushed. Delayed events are kept in a min-heap on absolute
+// simulation time and are moved to the front of the queue when they are due, in due time order. A removed
+// event is only marked as cancelled and skipped when it reaches the front, per type counts make duplicate
+// checks and removal O(1). Both queues are preallocated, a frame does not allocate.
 class Events {
  public:
   enum class QueueRule { AllowDuplicates, NoDuplicates };
 
-  Events() = default;
+  static const size_t kQueueCapacity = 256;
+  static const size_t kScheduledCapacity = 32;
+
+  Events() : events_(kQueueCapacity) { scheduled_.reserve(kScheduledCapacity); }
 
   Events(const Events&) = delete;
 
@@ -140,47 +208,122 @@ class Events {
     if (QueueRule::NoDuplicates == queue_rule) {
       Remove(type);
     }
-    events_.emplace_back(type);
+    Enqueue(Event(type));
   }
 
   template<class ...Args>
-  void Push(Args&&... args) { events_.emplace_back(std::forward<Args>(args)...); }
+  void Push(Args&&... args) { Enqueue(Event(std::forward<Args>(args)...)); }
+
+  // The event is due time seconds of simulation time from now
+  void Push(Event::Type type, double time) {
+    utility::Trace::Record(utility::TraceKind::EventSchedule, static_cast<uint8_t>(type), static_cast<int32_t>(time * 1000000.0));
+    scheduled_.push_back(Scheduled { now_ + time, sequence_++, Event(type) });
+    std::push_heap(scheduled_.begin(), scheduled_.end(), std::greater<>());
+  }
 
-  inline void Push(Event::Type type, double time) { events_with_delay_.emplace_back(type, time); }
+  void PushFront(Event::Type type) { PushFront(Event(type)); }
 
-  inline void PushFront(Event::Type type) { events_.emplace_front(type); }
+  void Remove(Event::Type type) {
+    const auto index = static_cast<size_t>(type);
+
+    if (queued_[index] > 0) {
+      live_ -= queued_[index];
+      queued_[index] = 0;
+      cancelled_before_[index] = sequence_;
+    }
+  }
 
-  inline void Remove(Event::Type type) { events_.erase(std::remove(events_.begin(), events_.end(), type), events_.end()); }
+  inline bool IsQueued(Event::Type type) const { return queued_[static_cast<size_t>(type)] > 0; }
 
   Event Pop() {
-    auto event = events_.front();
+    assert(live_ > 0);
+    while (IsCancelled(events_.front())) {
+      events_.pop_front();
+    }
+    auto event = events_.front().event_;
 
     events_.pop_front();
+    queued_[static_cast<size_t>(event.type())]--;
+    live_--;
+    Trace(utility::TraceKind::EventPop, event);
 
     return event;
   }
 
   void Clear() {
     events_.clear();
-    events_with_delay_.clear();
+    scheduled_.clear();
+    queued_.fill(0);
+    live_ = 0;
   }
 
-  inline bool IsEmpty() const { return events_.empty(); }
+  inline bool IsEmpty() const { return 0 == live_; }
 
+  // Advances the simulation time by delta seconds
   bool IsEmpty(double delta) {
-    for (auto it = events_with_delay_.begin(); it != events_with_delay_.end();) {
-      it->delay_ -= delta;
-      if (it->delay_ <= 0.0) {
-        events_.push_front(*it);
-        it = events_with_delay_.erase(it);
-      } else {
-        ++it;
-      }
+    now_ += delta;
+
+    auto due = scheduled_.end();
+
+    // Each pop moves the earliest event to the end of the heap, the due events end up latest first
+    while (due != scheduled_.begin() && scheduled_.front().due_ <= now_) {
+      std::pop_heap(scheduled_.begin(), due, std::greater<>());
+      --due;
+    }
+    // The due events go in front of the queued ones, earliest first
+    for (auto it = due; it != scheduled_.end(); ++it) {
+      PushFront(it->event_);
     }
-    return events_.empty();
+    scheduled_.erase(due, scheduled_.end());
+
+    return IsEmpty();
   }
 
+  inline double now() const { return now_; }
+
  private:
-  std::deque<Event> events_;
-  std::vector<Event> events_with_delay_;
+  struct Queued {
+    uint64_t sequence_ = 0;
+    Event event_ = Event(Event::Type::None);
+  };
+
+  struct Scheduled {
+    double due_;
+    uint64_t sequence_;
+    Event event_;
+
+    bool operator>(const Scheduled& rhs) const { return std::tie(due_, sequence_) > std::tie(rhs.due_, rhs.sequence_); }
+  };
+
+  void Enqueue(const Event& event) {
+    events_.push_back(Queued { sequence_++, event });
+    Count(event);
+  }
+
+  void PushFront(const Event& event) {
+    events_.push_front(Queued { sequence_++, event });
+    Count(event);
+  }
+
+  void Count(const Event& event) {
+    queued_[static_cast<size_t>(event.type())]++;
+    live_++;
+    Trace(utility::TraceKind::EventPush, event);
+  }
+
+  static void Trace(utility::TraceKind kind, const Event& event) {
+    utility::Trace::Record(kind, static_cast<uint8_t>(event.type()), event.value1_, event.value2_);
+  }
+
+  inline bool IsCancelled(const Queued& queued) const {
+    return queued.sequence_ < cancelled_before_[static_cast<size_t>(queued.event_.type())];
+  }
+
+  RingBuffer<Queued> events_;
+  std::vector<Scheduled> scheduled_;
+  std::array<uint32_t, Event::kNumberOfTypes> queued_ = {};
+  std::array<uint64_t, Event::kNumberOfTypes> cancelled_before_ = {};
+  uint64_t sequence_ = 0;
+  size_t live_ = 0;
+  double now_ = 0.0;
 };
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "game/board.h"
+
+#include <type_traits>
+
+// Everything needed to rewind a game to an earlier point, used for undo, rollback and search. It is a
+// plain value, taking a copy is a memcpy. Restore the matrix before the tetromino in play since the
+// tetromino is inserted in the restored matrix.
+struct GameStateSnapshot {
+  struct MatrixState {
+    // The color plane of the rows in matrix order, the bitboard is rebuilt from it
+    std::array<Board::ColorRow, kMatrixLastRow> colors_;
+    uint64_t garbage_random_;
+  };
+
+  struct SpriteState {
+    Tetromino::Type type_;
+    Position pos_;
+    Tetromino::Angle angle_;
+    Tetromino::Move last_move_;
+    int last_kick_;
+    int reset_delay_counter_;
+    int state_;
+    bool got_lines_;
+  };
+
+  // The queue is the piece stream of seed_ from piece next_, put_back_ comes first if it isn't empty
+  struct GeneratorState {
+    uint64_t seed_;
+    uint64_t next_;
+    uint64_t random_;
+    Tetromino::Type put_back_;
+  };
+
+  struct HoldQueueState {
+    Tetromino::Type tetromino_;
+    bool can_hold_;
+  };
+
+  struct ScoringState {
+    int combo_counter_;
+    int b2b_counter_;
+  };
+
+  // The lock delay timer and the part of a row gravity has built up
+  struct LevelState {
+    double time_;
+    double rows_;
+  };
+
+  MatrixState matrix_;
+  SpriteState sprite_;
+  GeneratorState generator_;
+  HoldQueueState hold_queue_;
+  ScoringState scoring_;
+  LevelState level_;
+};
+
+static_assert(std::is_trivially_copyable_v<GameStateSnapshot> && sizeof(GameStateSnapshot) < 512);
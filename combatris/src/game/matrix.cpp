@@ -1,29 +1,23 @@
 #include "game/matrix.h"
 #include "game/tetromino_tspin_detection.h"
 
-#include <random>
+#include <bit>
 #include <iomanip>
 #include <assert.h>
 
 namespace {
 
-const int kRows = kMatrixLastRow + 1;
-const int kCols = kVisibleCols + 4;
 const SDL_Rect kMatrixRc{ kMatrixStartX, kMatrixStartY - kBuffertVisible, kMatrixWidth, kMatrixHeight + kBuffertVisible };
 const SDL_Rect kMatrixClipRc{ kMatrixStartX - kMinoWidth, kMatrixStartY - kBuffertVisible,
                              kMatrixWidth + (kMinoWidth * 2), kMatrixHeight + kMinoHeight + kBuffertVisible };
 const SDL_Color kGray{ 51, 55, 66, 255 };
-std::mt19937 kGenerator{ std::random_device{}() };
-std::uniform_int_distribution<size_t> kDistribution(0, kVisibleCols - 1);
-const std::vector<int> kEmptyRow = { kBorderID, kBorderID, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, kBorderID, kBorderID };
-const std::vector<int> kSolidRow = { kBorderID, kBorderID, kSolidID, kSolidID, kSolidID, kSolidID,  kSolidID,
-                                    kSolidID,  kSolidID,  kSolidID, kSolidID, kSolidID, kBorderID, kBorderID };
+const SDL_Color kBlack{ 0, 0, 0, 255 };
 
 void Print(const Matrix::Type& matrix) {
   for (int row = 0; row < static_cast<int>(matrix.size()); ++row) {
     for (int col = 0; col < static_cast<int>(matrix.at(row).size()); ++ col) {
       std::cout << std::setw(2) <<matrix.at(row).at(col);
-      if (col < kCols -1 ) {
+      if (col < Board::kCols - 1) {
         std::cout << ", ";
       }
     }
@@ -31,251 +25,294 @@ void Print(const Matrix::Type& matrix) {
   }
 }
 
-void RenderGrid(SDL_Renderer* renderer) {
-  SDL_SetRenderDrawColor(renderer, kGray.r, kGray.g, kGray.b, kGray.a);
-  SDL_RenderFillRect(renderer, &kMatrixRc);
-  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+void AddGrid(utility::RenderBatch& batch) {
+  const auto white_rc = MinoAtlasRect(kMinoAtlasWhiteID);
+
+  batch.Add(kMatrixRc, white_rc, kGray);
 
   SDL_Rect rc { 0, kMatrixStartY - kMinoHeight, kMinoWidth - 2, kMinoHeight - 2 };
 
   for (int row = 0; row <= kVisibleRows; ++row) {
     rc.x = kMatrixStartX + 1;
     for (int col = 0; col < kVisibleCols; ++col) {
-      SDL_RenderFillRect(renderer, &rc);
+      batch.Add(rc, white_rc, kBlack);
       rc.x += kMinoWidth;
     }
     rc.y += kMinoHeight;
   }
 }
 
-void SetupPlayableArea(Matrix::Type& matrix) {
-  for (int row = 0; row < kMatrixLastRow; ++row) {
-    matrix[row] = kEmptyRow;
-  }
-}
+const uint64_t kAllRows = (uint64_t(1) << kMatrixLastRow) - 1;
+const uint64_t kVisibleRowsMask = kAllRows & ~((uint64_t(1) << kMatrixFirstRow) - 1);
+
+static_assert(std::tuple_size_v<Board::ColorRow> == 1, "A line is packed in a single color word");
 
-Lines RemoveLinesCleared(Matrix::Type& matrix) {
+Lines RemoveLinesCleared(Board& board) {
   Lines lines;
 
-  for (int row = kMatrixFirstRow; row < kMatrixLastRow; ++row) {
-    const auto& line = matrix[row];
+  for (auto full = board.Scan().full_ & kVisibleRowsMask; full != 0; full &= full - 1) {
+    const auto row = std::countr_zero(full);
 
-    if (kEmptyID == line[kMatrixFirstCol]) {
-      continue;
-    }
-    if (std::find_if(line.begin(), line.end(), [](auto elem) { return kEmptyID == elem || kBombID == elem; }) == line.end()) {
-      lines.push_back(Line(row, line));
-      matrix[row] = kEmptyRow;
-    }
+    lines.push_back(Line(row, board.colors(row)[0]));
   }
 
   return lines;
 }
 
-void MoveLineDown(int end_row, Matrix::Type& matrix) {
-  Matrix::Type tmp;
-
-  std::copy(matrix.begin(), std::next(matrix.begin(), end_row), std::back_inserter(tmp));
-  std::copy(tmp.begin(), tmp.end(), std::next(matrix.begin()));
-  matrix[0] = kEmptyRow;
-}
-
-void CollapseMatrix(const Lines& lines_cleared, Matrix::Type& matrix) {
+void CollapseMatrix(const Lines& lines_cleared, Board& board) {
   for (const auto& line : lines_cleared) {
-    MoveLineDown(line.row_, matrix);
+    board.MoveLineDown(line.row_);
   }
 }
 
-bool DetectPerfectClear(const Matrix::Type& matrix) { return kEmptyRow == matrix[matrix.size() - 3]; }
 
-int MoveLinesUp(int lines, Matrix::Type& matrix) {
-  int first_non_empty_row = 0;
+void InsertSolidLines(int lines, Board& board, utility::SplitMix64& random) {
+  int i = 0;
+  int n = 0;
 
-  for (int row = 0; row < kMatrixLastRow; ++row) {
-    first_non_empty_row = row;
-    if (matrix[row] != kEmptyRow) {
-      break;
+  for (int l = lines - 1; l >= 0; --l) {
+    if (i % 2 == 0) {
+      n = static_cast<int>(random.Next(kVisibleCols));
     }
+    i++;
+    board.InsertSolidLine(kMatrixLastRow - l - 1, kMatrixFirstCol + n);
   }
-  if (first_non_empty_row - lines <= 0)  {
-    return 0;
-  }
-  Matrix::Type tmp;
+}
 
-  std::copy(std::next(matrix.begin(), first_non_empty_row), std::prev(matrix.end(), 2), std::back_inserter(tmp));
+} // namespace
 
-  lines = std::min(lines, first_non_empty_row);
+void Matrix::Print(bool master) const {
+  if (master) {
+    Type matrix;
 
-  std::copy(tmp.begin(), tmp.end(), std::prev(matrix.end(), 2 + lines + tmp.size()));
+    board_.CopyTo(matrix);
+    ::Print(matrix);
+  } else {
+    Type matrix(Board::kRows, std::vector<int>(Board::kCols));
 
-  return lines;
+    for (int row = 0; row < Board::kRows; ++row) {
+      for (int col = 0; col < Board::kCols; ++col) {
+        matrix[row][col] = at(row, col);
+      }
+    }
+    ::Print(matrix);
+  }
 }
 
-void InsertSolidLines(int lines, Matrix::Type& matrix) {
-  int i = 0;
-  int n = 0;
+void Matrix::Initialize() {
+  board_.Reset();
+  ghost_ = active_ = Overlay();
+  UpdateSkyline();
+}
 
-  for (int l = lines - 1; l >= 0; --l) {
-    matrix[kMatrixLastRow - l - 1] = kSolidRow;
-    if (i % 2 == 0) {
-      n = static_cast<int>(kDistribution(kGenerator));
+void Matrix::UpdateSkyline() {
+  Board::Row occupied = 0;
+  Board::Row holes = 0;
+
+  column_top_.fill(kMatrixLastRow);
+  column_hole_.fill(kMatrixLastRow);
+  for (int row = board_.highest_row(); row < kMatrixLastRow; ++row) {
+    const auto filled = board_.row(row) & Board::kPlayableMask;
+
+    for (auto bits = filled & ~occupied; bits != 0; bits &= bits - 1) {
+      column_top_[std::countr_zero(bits) - kMatrixFirstCol] = row;
     }
-    i++;
-    matrix[kMatrixLastRow - l - 1][kMatrixFirstCol + n] = kBombID;
+    for (auto bits = occupied & ~filled & ~holes; bits != 0; bits &= bits - 1) {
+      column_hole_[std::countr_zero(bits) - kMatrixFirstCol] = row;
+    }
+    holes |= occupied & ~filled;
+    occupied |= filled;
   }
 }
 
-} // namespace
+void Matrix::UpdateSkyline(const Position& pos, const TetrominoRotationData& rotation_data) {
+  for (int col = rotation_data.first_col_; col <= rotation_data.last_col_; ++col) {
+    if (rotation_data.bottom_profile_[col] < 0) {
+      continue;
+    }
+    const auto c = pos.col() + col - kMatrixFirstCol;
+    const auto bottom = pos.row() + rotation_data.bottom_profile_[col];
+
+    if (bottom >= column_top_[c]) {
+      // Tucked in below an overhang, the holes of the column have changed
+      UpdateColumn(c);
+      continue;
+    }
+    if (bottom + 1 < column_top_[c]) {
+      column_hole_[c] = bottom + 1;
+    }
+    column_top_[c] = pos.row() + rotation_data.top_profile_[col];
+  }
+}
 
-void Matrix::Print(bool master) const { ::Print((master) ? master_matrix_ : matrix_); }
+void Matrix::UpdateColumn(int col) {
+  const auto bit = Board::Row(1) << (col + kMatrixFirstCol);
 
-void Matrix::Initialize() {
-  master_matrix_ = Matrix::Type(kRows + 1, std::vector<int>(kCols, kBorderID));
+  column_top_[col] = kMatrixLastRow;
+  column_hole_[col] = kMatrixLastRow;
+  for (int row = 0; row < kMatrixLastRow; ++row) {
+    const bool filled = (board_.row(row) & bit) != 0;
 
-  SetupPlayableArea(master_matrix_);
-  matrix_ = master_matrix_;
+    if (filled && kMatrixLastRow == column_top_[col]) {
+      column_top_[col] = row;
+    } else if (!filled && column_top_[col] < row) {
+      column_hole_[col] = row;
+      break;
+    }
+  }
 }
 
 void Matrix::Render(double) {
-  const Position kPosFirst(row_to_visible(kMatrixFirstRow - 1), col_to_visible(kMatrixFirstCol - 1));
-  const Position kPosLast(row_to_visible(kMatrixFirstRow - 1), col_to_visible(kMatrixLastCol));
-
-  RenderGrid(renderer_);
-  tetrominos_[kBorderID - 1]->Render(kPosFirst, kMinoWidth, kMinoHeight);
-  tetrominos_[kBorderID - 1]->Render(kPosLast, kMinoWidth, kMinoHeight);
-
+  const auto border_rc = MinoAtlasRect(kBorderID);
+  const auto white_rc = MinoAtlasRect(kMinoAtlasWhiteID);
+  const auto top = row_to_visible(kMatrixFirstRow - 1);
+
+  batch_.Clear();
+  AddGrid(batch_);
+  batch_.Add({ col_to_visible(kMatrixFirstCol - 1), top, kMinoWidth, kMinoHeight }, border_rc);
+  batch_.Add({ col_to_visible(kMatrixLastCol), top, kMinoWidth, kMinoHeight }, border_rc);
   for (int col = kMatrixFirstCol; col < kMatrixLastCol; ++col) {
-    const Position pos(row_to_visible(kMatrixFirstRow - 1), col_to_visible(col));
-
-    tetrominos_[kBorderID - 1]->Render(pos, kMinoWidth, kMinoHeight - kBuffertVisible);
+    batch_.Add({ col_to_visible(col), top, kMinoWidth, kMinoHeight - kBuffertVisible }, border_rc);
   }
 
-  SDL_RenderSetClipRect(renderer_, &kMatrixClipRc);
   for (int row = kMatrixFirstRow - 1; row <= kMatrixLastRow; ++row) {
     for (int col = kMatrixFirstCol - 1; col <= kMatrixLastCol; ++col) {
-      const int id = matrix_[row][col];
+      const int id = at(row, col);
 
       if (kEmptyID == id) {
         continue;
       }
-      const auto& tetromino = (id < kGhostAddOn) ? *tetrominos_[id - 1] : *tetrominos_[id - kGhostAddOn - 1];
-      const Position pos(row_to_visible(row), col_to_visible(col));
+      const SDL_Rect rc { col_to_visible(col), row_to_visible(row), kMinoWidth, kMinoHeight };
 
       if (id < kGhostAddOn) {
-        tetromino.Render(pos);
+        batch_.Add(rc, MinoAtlasRect(id), kMatrixClipRc);
       } else {
-        tetromino.RenderGhost(pos);
+        const SDL_Rect inner_rc { rc.x + 2, rc.y + 2, kMinoWidth - 4, kMinoHeight - 4 };
+
+        batch_.Add(rc, white_rc, kMatrixClipRc, tetrominos_[id - kGhostAddOn - 1]->color());
+        batch_.Add(inner_rc, white_rc, kMatrixClipRc, kBlack);
       }
     }
   }
-  SDL_RenderSetClipRect(renderer_, nullptr);
+  batch_.Render(renderer_, mino_atlas_.get());
+}
+
+void Matrix::Capture(GameStateSnapshot& snapshot) const {
+  board_.Capture(snapshot.matrix_.colors_);
+  snapshot.matrix_.garbage_random_ = garbage_random_.state();
+}
+
+void Matrix::Restore(const GameStateSnapshot& snapshot) {
+  board_.Restore(snapshot.matrix_.colors_);
+  garbage_random_.seed(snapshot.matrix_.garbage_random_);
+  ghost_ = active_ = Overlay();
+  UpdateSkyline();
+  is_dirty_ = true;
 }
 
-bool Matrix::InsertSolidLines(int lines, bool update_matrix) {
-  lines = MoveLinesUp(lines, master_matrix_);
+bool Matrix::InsertSolidLines(int lines) {
+  lines = board_.MoveLinesUp(lines);
 
   if (lines <= 0) {
     return false;
   }
-  ::InsertSolidLines(lines, master_matrix_);
+  ::InsertSolidLines(lines, board_, garbage_random_);
+  UpdateSkyline();
 
-  if (update_matrix) {
-    matrix_ = master_matrix_;
-  }
   return true;
 }
 
 void Matrix::RemoveSolidLines() {
-  Lines lines;
-
-  for (int row = 0; row < kMatrixLastRow; ++row) {
-    const auto& line = master_matrix_[row];
-
-    if (kSolidID == line[kMatrixFirstCol] || kBombID == line[kMatrixFirstCol]) {
-      lines.push_back(Line(row, line));
-    }
+  // Removing a row only moves the rows above it, so the rows below keep their scan bits
+  for (auto solid = board_.Scan().solid_; solid != 0; solid &= solid - 1) {
+    board_.MoveLineDown(std::countr_zero(solid));
   }
-  CollapseMatrix(lines, master_matrix_);
-  matrix_ = master_matrix_;
+  ghost_ = active_ = Overlay();
+  UpdateSkyline();
 }
 
 bool Matrix::IsAboveSkyline(const Position& pos, const TetrominoRotationData& rotation_data) const {
-  const auto& shape = rotation_data.shape_;
+  assert(rotation_data.last_row_ >= 0);
 
-  int last_row = -1;
+  return pos.row() + rotation_data.last_row_ < kMatrixFirstRow;
+}
 
-  for (int row = 0; row < static_cast<int>(shape.size()); ++row) {
-    for (int col  = 0; col < static_cast<int>(shape[row].size()); ++col) {
-      if (shape[row][col] == kEmptyID) {
-        continue;
-      }
-      last_row = pos.row() + row;
-    }
-  }
-  assert(last_row != -1);
+Position Matrix::GetDropPosition(const Position& current_pos, const TetrominoRotationData& rotation_data) const {
+  auto distance = kMatrixLastRow;
+  auto above_skyline = true;
 
-  return last_row < kMatrixFirstRow;
-}
+  for (int col = rotation_data.first_col_; col <= rotation_data.last_col_ && above_skyline; ++col) {
+    if (rotation_data.bottom_profile_[col] < 0) {
+      continue;
+    }
+    const auto bottom = current_pos.row() + rotation_data.bottom_profile_[col];
+    const auto top = column_top_[current_pos.col() + col - kMatrixFirstCol];
 
-bool Matrix::IsValid(const Position& pos, const TetrominoRotationData& rotation_data) const {
-  if (pos.col() < 0 || pos.row() < 0) {
-    return false;
+    above_skyline = bottom < top;
+    distance = std::min(distance, top - bottom - 1);
   }
-  const auto& shape = rotation_data.shape_;
-
-  for (int row = 0; row < static_cast<int>(shape.size()); ++row) {
-    for (int col  = 0; col < static_cast<int>(shape[row].size()); ++col) {
-      const auto elem = master_matrix_[pos.row() + row][pos.col() + col];
+  if (above_skyline) {
+    return Position(current_pos.row() + distance, current_pos.col());
+  }
+  // Below an overhang the column tops say nothing about the cells under the piece
+  Position pos(current_pos);
 
-      if (elem != kEmptyID && elem != kBombID && shape[row][col] != kEmptyID) {
-        return false;
-      }
-    }
+  while (IsValid(Position(pos.row() + 1, pos.col()), rotation_data)) {
+    pos.inc_row();
   }
 
-  return true;
+  return pos;
 }
 
-void Matrix::Insert(Type& matrix, const Position& pos, const TetrominoRotationData& rotation_data, bool insert_ghost) {
-  const auto ghost_add_on = (insert_ghost) ? kGhostAddOn : 0;
-  const auto& shape = rotation_data.shape_;
+Position Matrix::GetWallPosition(const Position& current_pos, const TetrominoRotationData& rotation_data, int direction) const {
+  const auto bottom = current_pos.row() + rotation_data.last_row_;
+  const auto first_col = (direction < 0) ? kMatrixFirstCol : current_pos.col() + rotation_data.first_col_;
+  const auto last_col = (direction < 0) ? current_pos.col() + rotation_data.last_col_ : kMatrixLastCol - 1;
+  auto above_skyline = true;
 
-  for (int row = 0; row < static_cast<int>(shape.size()); ++row) {
-    for (int col  = 0; col < static_cast<int>(shape[row].size()); ++col) {
-      if (kEmptyID == shape[row][col]) {
-        continue;
-      }
-      matrix[pos.row() + row][pos.col() + col] = shape[row][col] + ghost_add_on;
-    }
+  for (int col = first_col; col <= last_col && above_skyline; ++col) {
+    above_skyline = bottom < column_top_[col - kMatrixFirstCol];
   }
-}
+  if (above_skyline) {
+    const auto wall_col = (direction < 0) ? kMatrixFirstCol - rotation_data.first_col_ : kMatrixLastCol - 1 - rotation_data.last_col_;
 
-Position Matrix::GetDropPosition(const Position& current_pos, const TetrominoRotationData& rotation_data) const {
+    return Position(current_pos.row(), wall_col);
+  }
   Position pos(current_pos);
 
-  while (IsValid(Position(pos.row() + 1, pos.col()), rotation_data)) {
-    pos.inc_row();
+  while (IsValid(Position(pos.row(), pos.col() + direction), rotation_data)) {
+    pos = Position(pos.row(), pos.col() + direction);
   }
 
   return pos;
 }
 
-Matrix::CommitReturnType Matrix::Commit(Tetromino::Type type, Tetromino::Move latest_move, const Position& current_pos, const TetrominoRotationData& rotation_data) {
+Matrix::CommitReturnType Matrix::Commit(Tetromino::Type type, Tetromino::Move latest_move, const Position& current_pos,
+                                        const TetrominoRotationData& rotation_data, int last_kick) {
   auto pos = GetDropPosition(current_pos, rotation_data);
-
-  Insert(master_matrix_, pos, rotation_data);
-
   auto tspin_type = TSpinType::None;
 
-  if (Tetromino::Type::T == type && Tetromino::Move::Rotation == latest_move) {
-    tspin_type = DetectTSpin(master_matrix_, pos, rotation_data.angle_index_);
+  if (Tetromino::Move::Rotation == latest_move) {
+    if (Tetromino::Type::T == type) {
+      tspin_type = DetectTSpin(board_, pos, rotation_data.angle_index_, last_kick);
+    } else if (IsImmobile(board_, pos, rotation_data)) {
+      tspin_type = TSpinType::AllSpin;
+    }
   }
+  board_.Insert(pos, rotation_data);
+  ghost_ = active_ = Overlay();
 
-  auto lines_cleared = RemoveLinesCleared(master_matrix_);
+  auto lines_cleared = RemoveLinesCleared(board_);
 
-  CollapseMatrix(lines_cleared, master_matrix_);
+  CollapseMatrix(lines_cleared, board_);
+
+  if (lines_cleared.empty()) {
+    UpdateSkyline(pos, rotation_data);
+  } else {
+    UpdateSkyline();
+  }
 
-  auto perfect_clear = (lines_cleared.size() > 0 && DetectPerfectClear(master_matrix_));
+  auto perfect_clear = (lines_cleared.size() > 0 && IsPerfectClear());
 
   return std::make_tuple(lines_cleared, tspin_type, perfect_clear);
 }
@@ -1,18 +1,23 @@
 #pragma once
 
+#include "game/board.h"
 #include "game/events.h"
-#include "game/tetromino.h"
+#include "game/game_state_snapshot.h"
 #include "game/panes/pane_interface.h"
+#include "utility/random.h"
+#include "utility/render_batch.h"
 
 #include <tuple>
+#include <random>
 
-class Matrix final : public PaneInterface {
+class Matrix final : public PaneInterface, public EventListener {
  public:
   using Type = std::vector<std::vector<int>>;
   using CommitReturnType = std::tuple<Lines, TSpinType, bool>;
 
-  Matrix(SDL_Renderer* renderer, const std::vector<std::shared_ptr<const Tetromino>>& tetrominos)
-      : renderer_(renderer), tetrominos_(tetrominos) { Initialize(); }
+  Matrix(SDL_Renderer* renderer, const std::vector<std::shared_ptr<const Tetromino>>& tetrominos,
+         const std::shared_ptr<SDL_Texture>& mino_atlas)
+      : renderer_(renderer), tetrominos_(tetrominos), mino_atlas_(mino_atlas) { Initialize(); }
 
   // Used by test suit
   Matrix(const std::vector<std::vector<int>> &matrix,
@@ -29,15 +34,23 @@ class Matrix final : public PaneInterface {
 
     for (int row = kMatrixFirstRow; row < kMatrixLastRow; ++row) {
       for (int col = kMatrixFirstCol; col < kMatrixLastCol; ++col) {
-        master_matrix_.at(row).at(col) = matrix.at(row_to_visible(row)).at(col_to_visible(col));
+        board_.Set(row, col, matrix.at(row_to_visible(row)).at(col_to_visible(col)));
       }
     }
-    matrix_  = master_matrix_;
+    UpdateSkyline();
   }
 
-  const Type& data() const { return matrix_; }
+  // The committed board with the ghost and the tetromino in play on top
+  int at(int row, int col) const {
+    const auto bit = Board::Row(1) << col;
 
-  Type& data() { return matrix_; }
+    if (active_.row(row) & bit) {
+      return active_.id_;
+    } else if (ghost_.row(row) & bit) {
+      return ghost_.id_;
+    }
+    return board_.at(row, col);
+  }
 
   bool IsDirty() {
     bool ret_value = false;
@@ -51,55 +64,154 @@ class Matrix final : public PaneInterface {
 
   virtual void Reset() override { Initialize(); }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::MultiPlayerSetSeed };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
+  // Peers get the same seed, so they also get the same garbage holes
+  virtual void Update(const Event& event) override {
+    if (IsSubscribed(event.type())) {
+      garbage_random_.seed(event.value2_);
+    }
+  }
+
+  // The garbage hole stream, its state is part of a snapshot of the game
+  const utility::SplitMix64& garbage_random() const { return garbage_random_; }
+
+  void SetGarbageRandom(const utility::SplitMix64& random) { garbage_random_ = random; }
+
+  void Capture(GameStateSnapshot& snapshot) const;
+
+  // Clears the tetromino in play, it is inserted again when the sprite is restored
+  void Restore(const GameStateSnapshot& snapshot);
+
   static bool IsSolidLine(const Line& l) {
-    return (kSolidID == l.minos_[kMatrixFirstCol] || kBombID == l.minos_[kMatrixFirstCol]);
+    return (kSolidID == l.mino(kMatrixFirstCol) || kBombID == l.mino(kMatrixFirstCol));
   }
 
-  bool InsertSolidLines(int lines, bool update_matrix = true);
+  bool InsertSolidLines(int lines);
 
   void RemoveSolidLines();
 
   bool IsAboveSkyline(const Position& pos, const TetrominoRotationData& rotation_data) const;
 
-  bool IsValid(const Position& pos, const TetrominoRotationData& rotation_data) const;
+  inline bool IsValid(const Position& pos, const TetrominoRotationData& rotation_data) const { return board_.IsValid(pos, rotation_data); }
 
   void Insert(const Position& pos, const TetrominoRotationData& rotation_data) {
     is_dirty_ = true;
-    matrix_ = master_matrix_;
-    Insert(matrix_, GetDropPosition(pos, rotation_data), rotation_data, true);
-    Insert(matrix_, pos, rotation_data);
+    ghost_ = Overlay(GetDropPosition(pos, rotation_data), rotation_data, kGhostAddOn);
+    active_ = Overlay(pos, rotation_data);
   }
 
+  // Row of the highest occupied cell and of the first hole below it, kMatrixLastRow if there is none
+  inline int column_top(int col) const { return column_top_[col - kMatrixFirstCol]; }
+
+  inline int first_hole(int col) const { return column_hole_[col - kMatrixFirstCol]; }
+
+  // Occupancy of the committed board, all O(1)
+  inline int filled_cells(int row) const { return board_.filled(row); }
+
+  inline int filled_cells() const { return board_.total_filled(); }
+
+  // Row of the highest occupied cell, kMatrixLastRow if the matrix is empty
+  inline int highest_row() const { return board_.highest_row(); }
+
+  // Number of rows left between the stack and the top of the visible matrix, negative once it reaches the vanish zone
+  inline int rows_to_top_out() const { return board_.highest_row() - kMatrixFirstRow; }
+
+  inline bool IsPerfectClear() const { return 0 == board_.total_filled(); }
+
+  // Zobrist hash of the committed board and the tetromino in play, equal states hash the same on every peer
+  inline uint64_t hash() const { return board_.hash() ^ active_.hash(); }
+
+  // The same hash computed cell by cell, used to verify the incremental one
+  uint64_t ComputeHash() const { return board_.ComputeHash() ^ active_.hash(); }
+
   Position GetDropPosition(const Position& current_pos, const TetrominoRotationData& rotation_data) const;
 
-  auto Commit(Tetromino::Type type, Tetromino::Angle angle, Tetromino::Move latest_move, const Position& current_pos) {
-    return Commit(type, latest_move, current_pos, tetrominos_.at(static_cast<int>(type) - 1)->GetRotationData(angle));
+  // Position after shifting left (direction -1) or right (direction 1) as far as possible
+  Position GetWallPosition(const Position& current_pos, const TetrominoRotationData& rotation_data, int direction) const;
+
+  auto Commit(Tetromino::Type type, Tetromino::Angle angle, Tetromino::Move latest_move, const Position& current_pos, int last_kick = -1) {
+    return Commit(type, latest_move, current_pos, tetrominos_.at(static_cast<int>(type) - 1)->GetRotationData(angle), last_kick);
   }
 
-  CommitReturnType Commit(Tetromino::Type type, Tetromino::Move latest_move, const Position& pos, const TetrominoRotationData& rotation_data);
+  // last_kick is the index of the wall kick test used by the last rotation, 0 if unkicked and -1 if not rotated
+  CommitReturnType Commit(Tetromino::Type type, Tetromino::Move latest_move, const Position& pos, const TetrominoRotationData& rotation_data,
+                          int last_kick = -1);
 
   void Print(bool master = true) const;
 
  protected:
   void Initialize();
 
-  void Insert(Type& matrix, const Position& pos, const TetrominoRotationData& rotation_data, bool insert_ghost = false);
+  void UpdateSkyline();
+
+  void UpdateSkyline(const Position& pos, const TetrominoRotationData& rotation_data);
+
+  void UpdateColumn(int col);
 
  private:
+  // Grid, border, every cell and the inner fill of a ghost
+  static constexpr size_t kRenderBatchCapacity = 512;
+
   friend bool operator==(const Matrix& rhs, const Matrix::Type& lhs);
 
+  // A tetromino drawn on top of the committed board, only composed with the board when it is read
+  struct Overlay {
+    Overlay() = default;
+
+    Overlay(const Position& pos, const TetrominoRotationData& rotation_data, int add_on = 0)
+        : pos_(pos), masks_(rotation_data.masks_), id_(rotation_data.id_ + add_on) {}
+
+    inline Board::Row row(int r) const {
+      const auto shape_row = r - pos_.row();
+
+      if (shape_row < 0 || shape_row >= static_cast<int>(masks_.size())) {
+        return 0;
+      }
+      return Board::Row(masks_[shape_row]) << pos_.col();
+    }
+
+    // The masks tell the rotation apart, the id the tetromino
+    uint64_t hash() const {
+      if (kEmptyID == id_) {
+        return 0;
+      }
+      uint64_t key = static_cast<uint64_t>(id_);
+
+      for (auto mask : masks_) {
+        key = (key << 8) | mask;
+      }
+      key |= (static_cast<uint64_t>(pos_.row()) << 40) | (static_cast<uint64_t>(pos_.col()) << 52);
+
+      return utility::SplitMix64::Mix(key);
+    }
+
+    Position pos_;
+    TetrominoRotationData::Masks masks_ {};
+    int id_ = kEmptyID;
+  };
+
   SDL_Renderer* renderer_ = nullptr;
   std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
-  Type matrix_;
-  Type master_matrix_;
+  std::shared_ptr<SDL_Texture> mino_atlas_;
+  utility::RenderBatch batch_ { kRenderBatchCapacity };
+  Board board_;
+  Overlay ghost_;
+  Overlay active_;
+  std::array<int, kVisibleCols> column_top_;
+  std::array<int, kVisibleCols> column_hole_;
+  utility::SplitMix64 garbage_random_ { std::random_device{}() };
   bool is_dirty_ = false;
 };
 
 inline bool operator==(const Matrix& rhs, const Matrix::Type& lhs) {
   for (int row = kMatrixFirstRow; row < kMatrixLastRow; ++row) {
-    const auto& line = rhs.master_matrix_.at(row);
-    if (!std::equal(line.begin() + kMatrixFirstCol, line.end() - kMatrixFirstCol, lhs.at(row - kMatrixFirstRow).begin())) {
-      return false;
+    for (int col = kMatrixFirstCol; col < kMatrixLastCol; ++col) {
+      if (rhs.board_.at(row, col) != lhs.at(row_to_visible(row)).at(col_to_visible(col))) {
+        return false;
+      }
     }
   }
 
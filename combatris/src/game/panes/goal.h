@@ -16,8 +16,14 @@ class Goal final : public TextPane, public EventListener {
     SetCenteredText(goal_);
   }
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::LinesCleared, Event::Type::LevelUp, Event::Type::SetStartLevel, Event::Type::SetCampaign
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!IsIn(event, { Event::Type::LinesCleared, Event::Type::LevelUp, Event::Type::SetStartLevel, Event::Type::SetCampaign })) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     switch (event) {
@@ -16,8 +16,14 @@ class HighScore final : public TextPane, public EventListener {
 
   virtual void Reset() override { score_ = 0; }
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::CalculatedScore, Event::Type::DropScoreData, Event::Type::NewTime, Event::Type::SetCampaign
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!IsIn(event, { Event::Type::CalculatedScore, Event::Type::DropScoreData, Event::Type::NewTime, Event::Type::SetCampaign })) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     if (event.Is(Event::Type::NewTime)) {
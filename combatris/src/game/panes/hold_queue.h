@@ -24,8 +24,12 @@ class HoldQueue final : public TextPane, public EventListener {
     return type;
   }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::CanHold };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!event.Is(Event::Type::CanHold)) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     can_hold_ = true;
@@ -52,6 +56,13 @@ class HoldQueue final : public TextPane, public EventListener {
 
   inline bool CanHold() const { return can_hold_; }
 
+  void Capture(GameStateSnapshot& snapshot) const { snapshot.hold_queue_ = { tetromino_, can_hold_ }; }
+
+  void Restore(const GameStateSnapshot& snapshot) {
+    tetromino_ = snapshot.hold_queue_.tetromino_;
+    can_hold_ = snapshot.hold_queue_.can_hold_;
+  }
+
  private:
   double ticks_ = 1.0;
   bool can_hold_ = false;
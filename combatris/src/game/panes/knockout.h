@@ -23,8 +23,12 @@ class Knockout final : public Pane, public EventListener {
     plus_one_texture_.SetY(circle_texture_.y() + utility::Center(kCircleDim, plus_one_texture_.height()));
   }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::BattleYouDidKO };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!event.Is(Event::Type::BattleYouDidKO)) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     n_ko_ += 1;
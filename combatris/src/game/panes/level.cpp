@@ -25,15 +25,23 @@ const std::vector<LevelData> kLevelData = {
   LevelData(0.59, 0.5),
   LevelData(0.92, 0.5),
   LevelData(1.46, 0.5),
-  LevelData(2.36, 0.5)
+  LevelData(2.36, 0.5),
+  // Master levels, the tetromino drops to the floor the frame it spawns and the lock delay gets shorter
+  LevelData(20.0, 0.5),
+  LevelData(20.0, 0.45),
+  LevelData(20.0, 0.4),
+  LevelData(20.0, 0.35),
+  LevelData(20.0, 0.3)
 };
 
+static_assert(kMaxNumberOfLevels + kNumberOfMasterLevels == 20);
+
 } // namespace
 
 void Level::SetThresholds() {
   auto index = std::min(level_ - 1, static_cast<int>(kLevelData.size() - 1));
 
-  wait_time_ = (1.0 / kLevelData.at(index).gravity_) / 60.0;
+  gravity_.Set(kLevelData.at(index).gravity_);
   lock_delay_ = kLevelData.at(index).lock_delay_;
   lines_for_next_level_ = IsMarathonCampaign(campaign_type_) ? level_ * 5 : 10;
 }
@@ -46,18 +54,22 @@ void Level::SetLevel(int lvl) {
   SetCenteredText(level());
 }
 
-bool Level::WaitForMoveDown(double time_delta) {
-  time_ += time_delta;
-  if (time_ >= wait_time_) {
-    time_ = 0.0;
-    return true;
+int Level::WaitForMoveDown(double time_delta, int rows_to_floor) {
+  const auto rows = gravity_.Step(time_delta, kMatrixLastRow);
+
+  if (0 == rows) {
+    time_ += time_delta;
+  } else {
+    // The lock delay is counted from when the tetromino reached the floor, which can be part way into the step
+    time_ = (rows >= rows_to_floor) ? gravity_.TimeLeft(rows - rows_to_floor, time_delta) : 0.0;
   }
-  return false;
+
+  return rows;
 }
 
 bool Level::WaitForLockDelay(double time_delta) {
   time_ += time_delta;
-  if  (time_ >= lock_delay_) {
+  if  (time_ + Gravity::kEpsilon >= lock_delay_) {
     return true;
   }
   return false;
@@ -78,13 +90,16 @@ void Level::Update(const Event& event) {
       lines_this_level_ += event.value1_;
 
       if (lines_this_level_ >= lines_for_next_level_) {
+        // Only a game started on a master level goes on into the master levels
+        const auto last_level = (start_level_ > kMaxNumberOfLevels) ? static_cast<int>(kLevelData.size()) : kMaxNumberOfLevels;
+
         lines_this_level_ = 0;
         level_++;
-        if (level_ > static_cast<int>(kLevelData.size())) {
+        if (level_ > last_level) {
           if (IsMarathonCampaign(campaign_type_)) {
             events_.Push(Event::Type::GameOver, 1);
           } else {
-            level_ = static_cast<int>(kLevelData.size());
+            level_ = last_level;
           }
         } else {
           SetThresholds();
@@ -1,26 +1,97 @@
 #pragma once
 
 #include "game/events.h"
+#include "game/game_state_snapshot.h"
 #include "game/panes/pane.h"
 
+#include <algorithm>
+#include <cmath>
+
+// Gravity as rows per second. The fraction of a row that is left after a step is carried over to the next
+// step, so a tetromino falls the same number of rows in a given time at any frame rate. 20G is instant, the
+// tetromino is on the floor the step it spawns at any frame rate.
+class Gravity final {
+ public:
+  static constexpr double kInstant = 20.0;
+  // Steps are summed in floating point, a sum this close to a whole row or to the lock delay has reached it
+  static constexpr double kEpsilon = 1e-9;
+
+  // 1G is one row per frame at 60 frames per second
+  void Set(double gravity) {
+    rows_per_second_ = gravity * 60.0;
+    is_instant_ = gravity >= kInstant;
+  }
+
+  // Rows to fall for a step of time_delta seconds, at most max_rows
+  int Step(double time_delta, int max_rows) {
+    if (is_instant_) {
+      rows_ = 0.0;
+      return max_rows;
+    }
+    rows_ += time_delta * rows_per_second_;
+
+    const auto rows = std::floor(rows_ + kEpsilon);
+
+    rows_ -= rows;
+
+    return static_cast<int>(std::min(rows, static_cast<double>(max_rows)));
+  }
+
+  // The time left of the last step when all but rows_left of its rows had been fallen
+  double TimeLeft(int rows_left, double time_delta) const {
+    if (is_instant_ || rows_per_second_ <= 0.0) {
+      return time_delta;
+    }
+    return std::min(time_delta, (rows_left + std::max(rows_, 0.0)) / rows_per_second_);
+  }
+
+  // At least one row falls at the next step, used when a tetromino spawns or is hard dropped
+  inline void Release() { rows_ = std::max(rows_, 1.0); }
+
+  // Rows on top of the gravity, used for soft drop
+  inline void Add(double rows) { rows_ += rows; }
+
+  inline void Reset() { rows_ = 0.0; }
+
+  inline double rows() const { return rows_; }
+
+  inline void Restore(double rows) { rows_ = rows; }
+
+ private:
+  double rows_per_second_ = 0.0;
+  double rows_ = 0.0;
+  bool is_instant_ = false;
+};
+
 class Level final : public TextPane, public EventListener {
  public:
   Level(SDL_Renderer* renderer, int offset, Events& events, const std::shared_ptr<Assets>& assets)
       : TextPane(renderer, kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace), (kMatrixStartY - kMinoHeight) + offset, "LEVEL", assets),
         events_(events) { SetCenteredText(1); SetThresholds(); }
 
-  bool WaitForMoveDown(double time_delta);
+  // Rows the tetromino falls this step, 0 if it stays where it is. The time left of the step after the
+  // tetromino has fallen rows_to_floor rows counts towards the lock delay.
+  int WaitForMoveDown(double time_delta, int rows_to_floor);
 
   bool WaitForLockDelay(double time_delta);
 
   bool WaitForLockDelay() { return WaitForLockDelay(0); }
 
-  inline void Release() { time_ += 60.0; }
+  inline void Release() { gravity_.Release(); }
+
+  inline void SoftDrop() { gravity_.Add(1.0); }
+
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::SetCampaign, Event::Type::SetStartLevel, Event::Type::LinesCleared
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
 
   virtual void Update(const Event& event) override;
 
   virtual void Reset() override {
     time_ = 0.0;
+    gravity_.Reset();
     total_lines_ = 0;
     lines_this_level_ = 0;
     SetLevel(start_level_);
@@ -28,7 +99,17 @@ class Level final : public TextPane, public EventListener {
 
   inline int level() const { return level_; }
 
-  inline void ResetTime() { time_ = 0.0; }
+  inline void ResetTime() {
+    time_ = 0.0;
+    gravity_.Reset();
+  }
+
+  void Capture(GameStateSnapshot& snapshot) const { snapshot.level_ = { time_, gravity_.rows() }; }
+
+  void Restore(const GameStateSnapshot& snapshot) {
+    time_ = snapshot.level_.time_;
+    gravity_.Restore(snapshot.level_.rows_);
+  }
 
  protected:
   void SetThresholds();
@@ -38,7 +119,7 @@ class Level final : public TextPane, public EventListener {
  private:
   Events& events_;
   double time_ = 0.0;
-  double wait_time_ = 0.0;
+  Gravity gravity_;
   double lock_delay_ = 0.0;
   int total_lines_ = 0;
   int lines_this_level_ = 0;
@@ -18,8 +18,12 @@ class LinesSent final : public TextPane, public EventListener {
     SetCenteredText(std::to_string(0));
   }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::BattleSendLines };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!event.Is(Event::Type::BattleSendLines)) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     lines_sent_ += event.value1_;
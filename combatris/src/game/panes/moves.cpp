@@ -5,7 +5,7 @@ namespace {
 double kDisplayTime = 0.7;
 
 const std::vector<std::string> kBasicScoreTypes = { "", "SINGLE", "DOUBLE", "TRIPLE", "COMBATRIS" };
-const std::vector<std::string> kTSpinTypes = { "", "T-SPIN", "t-spin" };
+const std::vector<std::string> kTSpinTypes = { "", "T-SPIN", "t-spin", "SPIN" };
 const std::vector<std::string> kScoreModifiers = { "", "B2B #", "Combo #" };
 
 std::string GetComboType(const Event& event) {
@@ -25,7 +25,7 @@ std::string GetComboType(const Event& event) {
 
 
 void Moves::Update(const Event& event) {
-  if (!event.Is(Event::Type::Moves)) {
+  if (!IsSubscribed(event.type())) {
     return;
   }
   auto line1 = GetComboType(event);
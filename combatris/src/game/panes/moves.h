@@ -15,6 +15,10 @@ class Moves final : public TextPane, public EventListener {
     box_cleared_ = true;
   }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::Moves };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override;
 
   virtual void Render(double) override;
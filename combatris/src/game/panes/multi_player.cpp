@@ -13,14 +13,13 @@ MatrixState GetMatrixState(const std::shared_ptr<Matrix>& m) {
   MatrixState matrix_state;
 
   int i = 0;
-  const auto& matrix = m->data();
 
   for (int row = kMatrixFirstRow; row < kMatrixLastRow; ++row) {
-    const auto& col_vec = matrix[row];
-
     for (int col = kMatrixFirstCol; col < kMatrixLastCol; col +=2) {
-      auto e1 = (col_vec[col] >= kGhostAddOn) ? 0 : col_vec[col];
-      auto e2 = (col_vec[col + 1] >= kGhostAddOn) ? 0 : col_vec[col + 1];
+      const auto id1 = m->at(row, col);
+      const auto id2 = m->at(row, col + 1);
+      auto e1 = (id1 >= kGhostAddOn) ? 0 : id1;
+      auto e2 = (id2 >= kGhostAddOn) ? 0 : id2;
 
       matrix_state[i] = static_cast<uint8_t>((e1 << 4) | e2);
       i++;
@@ -14,6 +14,15 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
 
   virtual ~MultiPlayer() noexcept {}
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::HideMultiPlayerPanel, Event::Type::SetStartLevel, Event::Type::SetCampaign,
+    Event::Type::CalculatedScore, Event::Type::BattleSendLines, Event::Type::DropScoreData, Event::Type::LinesCleared,
+    Event::Type::LevelUp, Event::Type::GameOver, Event::Type::PlayerRejected, Event::Type::MultiplayerStartGame,
+    Event::Type::NewTime, Event::Type::BattleKnockedOut
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override;
 
   virtual void Reset() override {}
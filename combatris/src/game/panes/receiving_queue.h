@@ -67,6 +67,13 @@ class ReceivingQueue final : public TextPane, public EventListener {
     Reset();
   }
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::SetCampaign, Event::Type::BattleNextTetrominoSuccessful, Event::Type::BattleGotLines,
+    Event::Type::CalculatedScore
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
     if (Event::Type::SetCampaign == event.type()) {
       campaign_type_ = event.campaign_type();
@@ -111,7 +111,9 @@ std::tuple<int, int, ComboType, int, int> Scoring::Calculate(const Event& event)
       break;
     case TSpinType::TSpin:
     case TSpinType::TSpinMini:
-      if (TSpinType::TSpinMini == event.tspin_type_) {
+    case TSpinType::AllSpin:
+      // All-spins score as a T-spin mini
+      if (TSpinType::TSpin != event.tspin_type_) {
         if (event.lines() > 0) {
           lines_to_send += 1;
           lines_to_clear += 2;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "game/panes/level.h"
+#include "game/game_state_snapshot.h"
 
 class Scoring final : public Pane, public EventListener {
  public:
@@ -17,6 +18,20 @@ class Scoring final : public Pane, public EventListener {
 
   inline void ClearCounters() { combo_counter_ = b2b_counter_ = 0; }
 
+  void Capture(GameStateSnapshot& snapshot) const { snapshot.scoring_ = { combo_counter_, b2b_counter_ }; }
+
+  void Restore(const GameStateSnapshot& snapshot) {
+    combo_counter_ = snapshot.scoring_.combo_counter_;
+    b2b_counter_ = snapshot.scoring_.b2b_counter_;
+  }
+
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::SetCampaign, Event::Type::SetStartLevel, Event::Type::LevelUp, Event::Type::ClearedLinesScoreData,
+    Event::Type::DropScoreData
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override;
 
   virtual void Render(double) override { RenderCopy(score_texture_); }
@@ -8,6 +8,14 @@ class Timer final : public Pane, public EventListener {
  public:
   Timer (SDL_Renderer* renderer, const std::shared_ptr<Assets>& assets, Events& events);
 
+  static constexpr Event::Type kSubscriptions[] = {
+    Event::Type::SetCampaign, Event::Type::NewGame, Event::Type::Pause, Event::Type::CountdownAfterUnPauseDone,
+    Event::Type::GameOver, Event::Type::SprintClearedAll, Event::Type::NextTetromino,
+    Event::Type::MultiplayerResetCountDown
+  };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override;
 
   virtual void Reset() override;
@@ -13,8 +13,12 @@ class TotalLines final : public TextPane, public EventListener {
 
   virtual void Reset() override { total_lines_ = 0;  SetCenteredText(std::to_string(0)); }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::LinesCleared };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (!event.Is(Event::Type::LinesCleared)) {
+    if (!IsSubscribed(event.type())) {
       return;
     }
     total_lines_ += event.value1_;
@@ -0,0 +1,93 @@
+#include "game/randomizer.h"
+#include "utility/random.h"
+
+#include <array>
+#include <algorithm>
+
+namespace {
+
+using Type = Tetromino::Type;
+
+constexpr std::array<Type, 7> kTetrominos = { Type::I, Type::J, Type::L, Type::O, Type::S, Type::T, Type::Z };
+
+// Independent stream for piece, bag or block n of a seed
+inline utility::SplitMix64 Stream(uint64_t seed, uint64_t n) {
+  return utility::SplitMix64(utility::SplitMix64::Mix(seed + (n + 1) * 0xD1B54A32D192ED03));
+}
+
+template <size_t N>
+Type PieceInBag(const std::array<Type, N>& tetrominos, uint64_t seed, uint64_t n) {
+  auto bag = tetrominos;
+  auto random = Stream(seed, n / N);
+
+  for (int i = static_cast<int>(N) - 1; i > 0; --i) {
+    std::swap(bag[i], bag[random.Next(i + 1)]);
+  }
+  return bag[n % N];
+}
+
+constexpr std::array<Type, 14> MakeFourteenBag() {
+  std::array<Type, 14> bag {};
+
+  for (size_t i = 0; i < bag.size(); ++i) {
+    bag[i] = kTetrominos[i % kTetrominos.size()];
+  }
+  return bag;
+}
+
+constexpr std::array<Type, 14> kFourteenBag = MakeFourteenBag();
+
+const int kHistoryRolls = 4;
+
+constexpr std::array<Type, 4> kFirstTetrominos = { Type::I, Type::J, Type::L, Type::T };
+
+} // namespace
+
+Tetromino::Type SevenBagRandomizer::PieceAt(uint64_t seed, uint64_t n) const { return PieceInBag(kTetrominos, seed, n); }
+
+Tetromino::Type FourteenBagRandomizer::PieceAt(uint64_t seed, uint64_t n) const { return PieceInBag(kFourteenBag, seed, n); }
+
+Tetromino::Type HistoryRandomizer::PieceAt(uint64_t seed, uint64_t n) const {
+  const auto block = n / kBlockSize;
+  auto random = Stream(seed, block);
+  std::array<Type, 4> history = { Type::Z, Type::Z, Type::Z, Type::Z };
+  auto piece = Type::Empty;
+
+  for (uint64_t i = block * kBlockSize; i <= n; ++i) {
+    if (0 == i) {
+      piece = kFirstTetrominos[random.Next(static_cast<uint32_t>(kFirstTetrominos.size()))];
+    } else {
+      for (int roll = 0; roll < kHistoryRolls; ++roll) {
+        piece = kTetrominos[random.Next(static_cast<uint32_t>(kTetrominos.size()))];
+        if (std::find(history.begin(), history.end(), piece) == history.end()) {
+          break;
+        }
+      }
+    }
+    std::rotate(history.begin(), std::next(history.begin()), history.end());
+    history.back() = piece;
+  }
+  return piece;
+}
+
+Tetromino::Type PureRandomizer::PieceAt(uint64_t seed, uint64_t n) const {
+  return kTetrominos[Stream(seed, n).Next(static_cast<uint32_t>(kTetrominos.size()))];
+}
+
+const Randomizer& GetRandomizer(RandomizerType type) {
+  static const SevenBagRandomizer seven_bag;
+  static const FourteenBagRandomizer fourteen_bag;
+  static const HistoryRandomizer history;
+  static const PureRandomizer pure;
+
+  switch (type) {
+    case RandomizerType::FourteenBag:
+      return fourteen_bag;
+    case RandomizerType::History:
+      return history;
+    case RandomizerType::Random:
+      return pure;
+    default:
+      return seven_bag;
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "game/tetromino.h"
+
+#include <cstdint>
+
+enum class RandomizerType { SevenBag, FourteenBag, History, Random };
+
+// A randomizer maps a seed and a piece number to a tetromino. The stream is not replayed from the
+// start, so any piece can be looked up directly and the same seed gives the same stream on every peer.
+class Randomizer {
+ public:
+  virtual ~Randomizer() noexcept {}
+
+  virtual Tetromino::Type PieceAt(uint64_t seed, uint64_t n) const = 0;
+};
+
+// Every tetromino once in each bag of 7
+class SevenBagRandomizer final : public Randomizer {
+ public:
+  virtual Tetromino::Type PieceAt(uint64_t seed, uint64_t n) const override;
+};
+
+// Every tetromino twice in each bag of 14
+class FourteenBagRandomizer final : public Randomizer {
+ public:
+  virtual Tetromino::Type PieceAt(uint64_t seed, uint64_t n) const override;
+};
+
+// TGM style: up to 4 rolls for a tetromino that isn't one of the last 4, and the first tetromino is never
+// an S, Z or O. Not faithful to TGM, which fills the history with Z, Z, Z, Z once per game: here the history
+// is refilled with Z, Z, Z, Z every kBlockSize pieces so a lookup replays at most one block. The first pieces
+// of a block can therefore repeat the last pieces of the block before it.
+class HistoryRandomizer final : public Randomizer {
+ public:
+  static const int kBlockSize = 64;
+
+  virtual Tetromino::Type PieceAt(uint64_t seed, uint64_t n) const override;
+};
+
+class PureRandomizer final : public Randomizer {
+ public:
+  virtual Tetromino::Type PieceAt(uint64_t seed, uint64_t n) const override;
+};
+
+const Randomizer& GetRandomizer(RandomizerType type);
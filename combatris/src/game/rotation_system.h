@@ -0,0 +1,105 @@
+#pragma once
+
+#include "game/tetromino.h"
+
+#include <array>
+
+enum class RotationSystemType { SRS, SRSPlus, ARS };
+
+// A kick test as (col offset, row offset), rows grow downwards
+struct Kick {
+  int col_;
+  int row_;
+};
+
+template <size_t Tests>
+using KickTests = std::array<Kick, Tests>;
+
+// The kick tests of the eight rotations, indexed by RotationState
+template <size_t Tests>
+using KickTable = std::array<KickTests<Tests>, 8>;
+
+// 0 = spawn state
+// R = state resulting from a clockwise rotation ("right") from spawn
+// L = state resulting from a counter-clockwise ("left") rotation from spawn
+// 2 = state resulting from 2 successive rotations in either direction from spawn.
+//
+// The rotations are numbered 0->R, R->0, R->2, 2->R, 2->L, L->2, L->0, 0->L
+constexpr int RotationState(Tetromino::Angle from_angle, bool clockwise) {
+  const auto angle = static_cast<int>(from_angle);
+
+  return clockwise ? angle * 2 : (angle * 2 + 7) % 8;
+}
+
+template <size_t Tests>
+constexpr KickTable<Tests> SameForAllRotations(const KickTests<Tests>& kicks) {
+  KickTable<Tests> table {};
+
+  for (auto& tests : table) {
+    tests = kicks;
+  }
+  return table;
+}
+
+// Super Rotation System, the guideline rotation system
+struct SRS {
+  static constexpr KickTable<5> kJLSTZ = {{
+    {{ {0, 0}, {-1, 0}, {-1, -1}, {0, +2}, {-1, +2} }}, // 0->R S0
+    {{ {0, 0}, {+1, 0}, {+1, +1}, {0, -2}, {+1, -2} }}, // R->0 S1
+    {{ {0, 0}, {+1, 0}, {+1, +1}, {0, -2}, {+1, -2} }}, // R->2 S2
+    {{ {0, 0}, {-1, 0}, {-1, -1}, {0, +2}, {-1, +2} }}, // 2->R S3
+    {{ {0, 0}, {+1, 0}, {+1, -1}, {0, +2}, {+1, +2} }}, // 2->L S4
+    {{ {0, 0}, {-1, 0}, {-1, +1}, {0, -2}, {-1, -2} }}, // L->2 S5
+    {{ {0, 0}, {-1, 0}, {-1, +1}, {0, -2}, {-1, -2} }}, // L->0 S6
+    {{ {0, 0}, {+1, 0}, {+1, -1}, {0, +2}, {+1, +2} }}  // 0->L S7
+  }};
+
+  static constexpr KickTable<5> kI = {{
+    {{ {0, 0}, {-2, 0}, {+1, 0}, {-2, +1}, {+1, -2} }}, // 0->R S0
+    {{ {0, 0}, {+2, 0}, {-1, 0}, {+2, -1}, {-1, +2} }}, // R->0 S1
+    {{ {0, 0}, {-1, 0}, {+2, 0}, {-1, -2}, {+2, +1} }}, // R->2 S2
+    {{ {0, 0}, {+1, 0}, {-2, 0}, {+1, +2}, {-2, -1} }}, // 2->R S3
+    {{ {0, 0}, {+2, 0}, {-1, 0}, {+2, -1}, {-1, +2} }}, // 2->L S4
+    {{ {0, 0}, {-2, 0}, {+1, 0}, {-2, +1}, {+1, -2} }}, // L->2 S5
+    {{ {0, 0}, {+1, 0}, {-2, 0}, {+1, +2}, {-2, -1} }}, // L->0 S6
+    {{ {0, 0}, {-1, 0}, {+2, 0}, {-1, -2}, {+2, +1} }}  // 0->L S7
+  }};
+
+  // Index of the kJLSTZ test that moves the tetromino one column and two rows (the "TST" kick)
+  static constexpr int kTSpinUpgradeKick = 4;
+};
+
+static_assert([] {
+  for (const auto& tests : SRS::kJLSTZ) {
+    const auto& kick = tests[SRS::kTSpinUpgradeKick];
+
+    if (kick.col_ * kick.col_ != 1 || kick.row_ * kick.row_ != 4) {
+      return false;
+    }
+  }
+  return true;
+}(), "kTSpinUpgradeKick must index the one column two rows kick in SRS::kJLSTZ");
+
+// SRS with symmetric I kicks, a rotation and its mirror image kick the same way
+struct SRSPlus {
+  static constexpr KickTable<5> kJLSTZ = SRS::kJLSTZ;
+
+  static constexpr KickTable<5> kI = {{
+    {{ {0, 0}, {+1, 0}, {-2, 0}, {-2, +1}, {+1, -2} }}, // 0->R S0
+    {{ {0, 0}, {-1, 0}, {+2, 0}, {-1, +2}, {+2, -1} }}, // R->0 S1
+    {{ {0, 0}, {-1, 0}, {+2, 0}, {-1, -2}, {+2, +1} }}, // R->2 S2
+    {{ {0, 0}, {-2, 0}, {+1, 0}, {-2, -1}, {+1, +2} }}, // 2->R S3
+    {{ {0, 0}, {+2, 0}, {-1, 0}, {+2, -1}, {-1, +2} }}, // 2->L S4
+    {{ {0, 0}, {+1, 0}, {-2, 0}, {+1, -2}, {-2, +1} }}, // L->2 S5
+    {{ {0, 0}, {+1, 0}, {-2, 0}, {+1, +2}, {-2, -1} }}, // L->0 S6
+    {{ {0, 0}, {-1, 0}, {+2, 0}, {+2, +1}, {-1, -2} }}  // 0->L S7
+  }};
+};
+
+// Arika style kicks: one step right, then one step left, and the I tetromino never kicks. The tetrominos
+// keep their SRS shapes and the center column rule is not applied.
+struct ARS {
+  static constexpr KickTable<3> kJLSTZ = SameForAllRotations<3>({{ {0, 0}, {+1, 0}, {-1, 0} }});
+
+  static constexpr KickTable<1> kI = SameForAllRotations<1>({{ {0, 0} }});
+};
@@ -0,0 +1,151 @@
+#include "game/row_scan.h"
+#include "game/tetromino.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define COMBATRIS_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define COMBATRIS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define COMBATRIS_TARGET_AVX2
+#endif
+
+namespace {
+
+// Solid and bomb ids only differ in the lowest bit
+static_assert(kBombID == (kSolidID | 1));
+
+const uint64_t kSolidMask = 0xE;
+
+using ScanFunction = RowScan (*)(const uint32_t*, const uint64_t*, int, uint32_t, uint32_t, int);
+
+void ScanTail(RowScan& scan, const uint32_t* rows, int first, int count, uint32_t full_row, uint32_t empty_row) {
+  for (int r = first; r < count; ++r) {
+    scan.full_ |= static_cast<uint64_t>(full_row == rows[r]) << r;
+    scan.empty_ |= static_cast<uint64_t>(empty_row == rows[r]) << r;
+  }
+}
+
+void ScanSolidTail(RowScan& scan, const uint64_t* colors, int first, int count, int solid_shift) {
+  for (int r = first; r < count; ++r) {
+    scan.solid_ |= static_cast<uint64_t>(((colors[r] >> solid_shift) & kSolidMask) == uint64_t(kSolidID)) << r;
+  }
+}
+
+#if defined(COMBATRIS_X86_SIMD)
+
+RowScan ScanRowsSSE2(const uint32_t* rows, const uint64_t* colors, int count, uint32_t full_row, uint32_t empty_row, int solid_shift) {
+  RowScan scan;
+  const auto full = _mm_set1_epi32(static_cast<int>(full_row));
+  const auto empty = _mm_set1_epi32(static_cast<int>(empty_row));
+  int r = 0;
+
+  for (; r + 4 <= count; r += 4) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + r));
+
+    scan.full_ |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, full)))) << r;
+    scan.empty_ |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, empty)))) << r;
+  }
+  ScanTail(scan, rows, r, count, full_row, empty_row);
+
+  if (solid_shift + 4 <= 32) {
+    // SSE2 has no 64-bit compare, the nibble is in the low half of the color word so compare that half only
+    const auto mask = _mm_set1_epi64x(static_cast<long long>(kSolidMask << solid_shift));
+    const auto solid = _mm_set1_epi64x(static_cast<long long>(uint64_t(kSolidID) << solid_shift));
+
+    for (r = 0; r + 2 <= count; r += 2) {
+      const auto v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + r)), mask);
+      const auto bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, solid)));
+
+      scan.solid_ |= static_cast<uint64_t>((bits & 1) | ((bits >> 1) & 2)) << r;
+    }
+  } else {
+    r = 0;
+  }
+  ScanSolidTail(scan, colors, r, count, solid_shift);
+
+  return scan;
+}
+
+COMBATRIS_TARGET_AVX2
+RowScan ScanRowsAVX2(const uint32_t* rows, const uint64_t* colors, int count, uint32_t full_row, uint32_t empty_row, int solid_shift) {
+  RowScan scan;
+  const auto full = _mm256_set1_epi32(static_cast<int>(full_row));
+  const auto empty = _mm256_set1_epi32(static_cast<int>(empty_row));
+  int r = 0;
+
+  for (; r + 8 <= count; r += 8) {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + r));
+
+    scan.full_ |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, full)))) << r;
+    scan.empty_ |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, empty)))) << r;
+  }
+  ScanTail(scan, rows, r, count, full_row, empty_row);
+
+  const auto mask = _mm256_set1_epi64x(static_cast<long long>(kSolidMask << solid_shift));
+  const auto solid = _mm256_set1_epi64x(static_cast<long long>(uint64_t(kSolidID) << solid_shift));
+
+  for (r = 0; r + 4 <= count; r += 4) {
+    const auto v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors + r)), mask);
+
+    scan.solid_ |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, solid)))) << r;
+  }
+  ScanSolidTail(scan, colors, r, count, solid_shift);
+
+  return scan;
+}
+
+bool CpuSupportsAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  // OSXSAVE and AVX, then check that the OS saves the YMM registers
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+RowScan ScanRowsScalar(const uint32_t* rows, const uint64_t* colors, int count, uint32_t full_row, uint32_t empty_row, int solid_shift) {
+  RowScan scan;
+
+  ScanTail(scan, rows, 0, count, full_row, empty_row);
+  ScanSolidTail(scan, colors, 0, count, solid_shift);
+
+  return scan;
+}
+
+#endif
+
+ScanFunction SelectScanFunction() {
+#if defined(COMBATRIS_X86_SIMD)
+  return (CpuSupportsAVX2()) ? ScanRowsAVX2 : ScanRowsSSE2;
+#else
+  return ScanRowsScalar;
+#endif
+}
+
+} // namespace
+
+RowScan ScanRows(const uint32_t* rows, const uint64_t* colors, int count, uint32_t full_row, uint32_t empty_row, int solid_shift) {
+  static const ScanFunction scan_function = SelectScanFunction();
+
+  return scan_function(rows, colors, count, full_row, empty_row, solid_shift);
+}
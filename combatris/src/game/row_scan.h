@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Result of a scan over the board rows, bit r is set when row r is full, empty or a solid (garbage) line
+struct RowScan {
+  uint64_t full_ = 0;
+  uint64_t empty_ = 0;
+  uint64_t solid_ = 0;
+};
+
+// Scans at most 64 rows in one pass. Rows are compared against the full and empty row words and a row is
+// solid when the color nibble at solid_shift is a solid or a bomb mino. The kernel (AVX2, SSE2 or scalar)
+// is chosen the first time it is called.
+RowScan ScanRows(const uint32_t* rows, const uint64_t* colors, int count, uint32_t full_row, uint32_t empty_row, int solid_shift);
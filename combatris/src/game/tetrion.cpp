@@ -88,7 +88,7 @@ Tetrion::Tetrion() : events_() {
 
   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
   assets_ = std::make_shared<Assets>(renderer_);
-  matrix_ = std::make_shared<Matrix>(renderer_, assets_->GetTetrominos());
+  matrix_ = std::make_shared<Matrix>(renderer_, assets_->GetTetrominos(), assets_->GetMinoAtlas());
   campaign_ = std::make_shared<Campaign>(window_, renderer_, events_, assets_, matrix_);
   hold_queue_ = campaign_->GetHoldQueuePane();
   multi_player_ = campaign_->GetMultiPlayerPane();
@@ -156,6 +156,12 @@ void Tetrion::GameControl(Controls control_pressed, int lines) {
     case Controls::Right:
       tetromino_in_play_->Right();
       break;
+    case Controls::LeftToWall:
+      tetromino_in_play_->ShiftToWall(-1);
+      break;
+    case Controls::RightToWall:
+      tetromino_in_play_->ShiftToWall(1);
+      break;
     case Controls::Hold:
       if (hold_queue_->CanHold()) {
         if (auto tetromino_type = hold_queue_->Hold(tetromino_in_play_); Tetromino::Type::Empty != tetromino_type) {
@@ -204,7 +210,9 @@ void Tetrion::EventHandler(Events& events, double delta_time) {
   if (events.IsEmpty(delta_time)) {
     return;
   }
-  auto event = campaign_->PreprocessEvent(events.Pop());
+  const auto event = events.Pop();
+
+  campaign_->PreprocessEvent(event);
 
   switch (event.type()) {
     case Event::Type::ShowSplashScreen:
@@ -298,7 +306,7 @@ void Tetrion::EventHandler(Events& events, double delta_time) {
       AddAnimation<MessageAnimation>(renderer_, assets_, "Sent " + std::to_string(event.value1_) + " lines", Color::SteelGray, 200.0);
       break;
     case Event::Type::RoyalNewLine:
-      if (!matrix_->InsertSolidLines(1, false)) {
+      if (!matrix_->InsertSolidLines(1)) {
         HandleTetrominoStates(TetrominoSprite::State::GameOver, events_);
       }
       if (tetromino_in_play_ && !tetromino_in_play_->Update()) {
@@ -328,5 +336,4 @@ void Tetrion::Update(double delta_time) {
       HandleTetrominoStates(tetromino_in_play_->Down(delta_time), events_);
     }
   }
-  Render(delta_time);
 }
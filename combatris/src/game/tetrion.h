@@ -4,6 +4,8 @@
 #include "game/animation.h"
 #include "utility/game_controller.h"
 
+#include <deque>
+
 class Tetrion final {
  public:
   enum class Controls {
@@ -20,6 +22,9 @@ class Tetrion final {
     HideMultiplayerPanel,
     Quit,
     DebugSendLine,
+    LeftToWall,
+    RightToWall,
+    DumpTrace,
     Up = HardDrop,
     UpKeyBoard = RotateClockwise,
     Down = SoftDrop
@@ -54,8 +59,12 @@ class Tetrion final {
 
   void HandleGameControllerEvents(SDL_Event& event) { game_controller_->HandleEvents(event); }
 
+  void ReportEventStatistics(std::ostream& os) const { campaign_->ReportEventStatistics(os); }
+
   void Update(double delta_timer);
 
+  void Render(double delta_timer);
+
  protected:
   template<class T, class ...Args>
   void AddAnimation(Args&&... args) { animations_.push_back(std::make_shared<T>(std::forward<Args>(args)...)); }
@@ -66,8 +75,6 @@ class Tetrion final {
 
   void EventHandler(Events& events, double delta_time);
 
-  void Render(double delta_timer);
-
  private:
   SDL_Window* window_ = nullptr;
   SDL_Renderer* renderer_ = nullptr;
@@ -13,7 +13,7 @@ class Tetromino final {
   enum class Angle { A0, A90, A180, A270 };
   enum class Type { Empty, I, J, L, O, S, T, Z, Solid, Bomb, Border };
 
-  Tetromino(SDL_Renderer *renderer, Type type, SDL_Color color, const std::vector<TetrominoRotationData>& rotations,
+  Tetromino(SDL_Renderer *renderer, Type type, SDL_Color color, const TetrominoRotations& rotations,
             const std::shared_ptr<SDL_Texture> &texture)
       : renderer_(renderer), type_(type), color_(color), rotations_(rotations), texture_(texture) {}
 
@@ -23,14 +23,14 @@ class Tetromino final {
 
   inline SDL_Texture* texture() const { return texture_.get(); }
 
+  inline const SDL_Color& color() const { return color_; }
+
   inline void Render(int x, int y) const { RenderMino(renderer_, x, y, texture_.get()); }
 
   inline void Render(const Position& pos) const { RenderMino(renderer_, pos.x(), pos.y(), texture_.get()); }
 
   inline void Render(const Position& pos, int w, int h) const { RenderMino(renderer_, pos.x(), pos.y(), w, h, texture_.get()); }
 
-  inline void RenderGhost(const Position& pos) const { ::RenderGhost(renderer_, pos.x(), pos.y(), color_); }
-
   const TetrominoRotationData& GetRotationData(Angle angle) const { return rotations_.at(static_cast<size_t>(angle)); }
 
   void Render(int x, int y, SDL_Texture* texture, Angle angle) const {
@@ -77,7 +77,7 @@ class Tetromino final {
   SDL_Renderer *renderer_;
   Type type_;
   SDL_Color color_;
-  std::vector<TetrominoRotationData> rotations_;
+  TetrominoRotations rotations_;
   std::shared_ptr<SDL_Texture> texture_;
 };
 
@@ -86,3 +86,9 @@ const int kBombID = static_cast<int>(Tetromino::Type::Bomb);
 const int kBorderID = static_cast<int>(Tetromino::Type::Border);
 const int kSolidID = static_cast<int>(Tetromino::Type::Solid);
 const int kGhostAddOn = kBorderID + 1;
+
+// The mino atlas has one cell per tetromino id followed by a white cell used for colored fills
+const int kMinoAtlasWhiteID = kBorderID + 1;
+const int kMinoAtlasCells = kMinoAtlasWhiteID;
+
+inline SDL_Rect MinoAtlasRect(int id) { return SDL_Rect { (id - 1) * kMinoWidth, 0, kMinoWidth, kMinoHeight }; }
@@ -1,69 +1,109 @@
 #pragma once
 
 #include "game/assets.h"
+#include "game/randomizer.h"
 #include "game/tetromino_sprite.h"
+#include "utility/random.h"
 
-#include <deque>
 #include <random>
 
 class TetrominoGenerator final : public EventListener {
  public:
   TetrominoGenerator(std::shared_ptr<Matrix>& matrix, std::shared_ptr<Level>& level, Events& events, const std::shared_ptr<Assets>& assets)
       : matrix_(matrix), level_(level), events_(events), assets_(assets) {
-    GenerateTetrominos();
+    for (int i = 0; i < kSpritePoolSize; ++i) {
+      sprites_.push_back(std::make_shared<TetrominoSprite>(*assets_->GetTetromino(Tetromino::Type::I), level_, events_, matrix_));
+    }
+    Reset();
   }
 
+  static constexpr Event::Type kSubscriptions[] = { Event::Type::MultiPlayerSetSeed };
+
+  virtual EventTypes Subscriptions() const override { return kSubscriptions; }
+
   virtual void Update(const Event& event) override {
-    if (event.Is(Event::Type::MultiPlayerSetSeed)) {
-      engine_.seed(event.value2_);
+    if (IsSubscribed(event.type())) {
+      random_.seed(event.value2_);
       Reset();
     }
   }
 
   std::shared_ptr<TetrominoSprite> Get() {
-    auto tetromino = tetrominos_queue_.front();
+    auto tetromino = put_back_;
 
-    tetrominos_queue_.pop_front();
-    if (tetrominos_queue_.size() == kTetrominos.size()) {
-      GenerateTetrominos();
+    if (Tetromino::Type::Empty == tetromino) {
+      tetromino = randomizer_->PieceAt(seed_, next_++);
     }
+    put_back_ = Tetromino::Type::Empty;
+
     return Get(tetromino);
   }
 
+  // Hands out a pooled sprite that nothing else holds on to, the pool only grows if an animation keeps an old sprite
   std::shared_ptr<TetrominoSprite> Get(Tetromino::Type type) {
-    return std::make_shared<TetrominoSprite>(*assets_->GetTetromino(type), level_,  events_, matrix_);
+    auto it = std::find_if(sprites_.begin(), sprites_.end(), [](const auto& sprite) { return 1 == sprite.use_count(); });
+
+    if (sprites_.end() == it) {
+      it = sprites_.insert(sprites_.end(), std::make_shared<TetrominoSprite>(*assets_->GetTetromino(type), level_, events_, matrix_));
+    }
+    (*it)->Reset(*assets_->GetTetromino(type), rotation_system_);
+
+    return *it;
   }
 
+  // Used by test suit
+  size_t pool_size() const { return sprites_.size(); }
+
+  // Every game draws a new seed for the piece stream, after MultiPlayerSetSeed the seeds are the same on all peers
   void Reset() {
-    tetrominos_queue_.clear();
-    GenerateTetrominos();
+    seed_ = random_();
+    next_ = 0;
+    put_back_ = Tetromino::Type::Empty;
   }
 
-  void Put(Tetromino::Type type) { tetrominos_queue_.push_front(type); }
+  void SetRotationSystem(RotationSystemType rotation_system) { rotation_system_ = rotation_system; }
 
-  void RenderFromQueue(size_t n, int x, int y) const { assets_->GetTetromino(tetrominos_queue_.at(n))->RenderTetromino(x, y); }
+  void SetRandomizer(RandomizerType type) { randomizer_ = &GetRandomizer(type); }
 
- protected:
-  const std::deque<Tetromino::Type> kTetrominos = { Tetromino::Type::I, Tetromino::Type::J, Tetromino::Type::L, Tetromino::Type::O, Tetromino::Type::S, Tetromino::Type::T, Tetromino::Type::Z };
-
-  void GenerateTetrominos() {
-    auto tetrominos = kTetrominos;
-    std::shuffle(std::begin(tetrominos), std::end(tetrominos), engine_);
-    if (!tetrominos_queue_.empty()) {
-      tetrominos_queue_.insert(tetrominos_queue_.end(), tetrominos.begin(), tetrominos.end());
-    } else {
-      tetrominos_queue_ = tetrominos;
-      tetrominos = kTetrominos;
-      std::shuffle(std::begin(tetrominos), std::end(tetrominos), engine_);
-      tetrominos_queue_.insert(tetrominos_queue_.end(), tetrominos.begin(), tetrominos.end());
+  // The tetromino given back by the hold queue is the next one out
+  void Put(Tetromino::Type type) { put_back_ = type; }
+
+  // Any tetromino ahead in the queue, n = 0 is the next one
+  Tetromino::Type Peek(size_t n) const {
+    if (Tetromino::Type::Empty != put_back_) {
+      if (0 == n) {
+        return put_back_;
+      }
+      --n;
     }
+    return randomizer_->PieceAt(seed_, next_ + n);
+  }
+
+  void RenderFromQueue(size_t n, int x, int y) const { assets_->GetTetromino(Peek(n))->RenderTetromino(x, y); }
+
+  void Capture(GameStateSnapshot& snapshot) const { snapshot.generator_ = { seed_, next_, random_.state(), put_back_ }; }
+
+  void Restore(const GameStateSnapshot& snapshot) {
+    seed_ = snapshot.generator_.seed_;
+    next_ = snapshot.generator_.next_;
+    random_.seed(snapshot.generator_.random_);
+    put_back_ = snapshot.generator_.put_back_;
   }
 
+ protected:
+  // The tetromino in play and the one an on floor animation may still refer to
+  static const int kSpritePoolSize = 2;
+
  private:
   std::shared_ptr<Matrix> matrix_;
   std::shared_ptr<Level> level_;
   Events& events_;
   std::shared_ptr<Assets> assets_;
-  std::deque<Tetromino::Type> tetrominos_queue_;
-  mutable std::mt19937 engine_ { std::random_device{}() };
+  std::vector<std::shared_ptr<TetrominoSprite>> sprites_;
+  const Randomizer* randomizer_ = &GetRandomizer(RandomizerType::SevenBag);
+  uint64_t seed_ = 0;
+  uint64_t next_ = 0;
+  Tetromino::Type put_back_ = Tetromino::Type::Empty;
+  RotationSystemType rotation_system_ = RotationSystemType::SRS;
+  utility::SplitMix64 random_ { std::random_device{}() };
 };
@@ -2,90 +2,102 @@
 
 #include "game/constants.h"
 
+#include <array>
 #include <vector>
-
-// 0 = spawn state
-// R = state resulting from a clockwise rotation ("right") from spawn
-// L = state resulting from a counter-clockwise ("left") rotation from spawn
-// 2 = state resulting from 2 successive rotations in either direction from spawn.
-//
-// The kick-values are represented as (col offset, row offset).
-
-// J, L, S, T, Z Tetromino Wall Kick Data
-const std::vector<std::vector<std::vector<int>>> kWallKickDataForJLSTZ = {
-    { {0, 0}, {-1, 0}, {-1, -1}, {0, +2}, {-1, +2} }, // 0->R S0
-    { {0, 0}, {+1, 0}, {+1, +1}, {0, -2}, {+1, -2} }, // R->0 S1
-    { {0, 0}, {+1, 0}, {+1, +1}, {0, -2}, {+1, -2} }, // R->2 S2
-    { {0, 0}, {-1, 0}, {-1, -1}, {0, +2}, {-1, +2} }, // 2->R S3
-    { {0, 0}, {+1, 0}, {+1, -1}, {0, +2}, {+1, +2} }, // 2->L S4
-    { {0, 0}, {-1, 0}, {-1, +1}, {0, -2}, {-1, -2} }, // L->2 S5
-    { {0, 0}, {-1, 0}, {-1, +1}, {0, -2}, {-1, -2} }, // L->0 S6
-    { {0, 0}, {+1, 0}, {+1, -1}, {0, +2}, {+1, +2} }  // 0->L S7
-};
-
-// I Tetromino Wall Kick Data
-const std::vector<std::vector<std::vector<int>>> kWallKickDataForI = {
-    { {0, 0}, {-2, 0}, {+1, 0}, {-2, +1}, {+1, -2} }, // 0->R S0
-    { {0, 0}, {+2, 0}, {-1, 0}, {+2, -1}, {-1, +2} }, // R->0 S1
-    { {0, 0}, {-1, 0}, {+2, 0}, {-1, -2}, {+2, +1} }, // R->2 S2
-    { {0, 0}, {+1, 0}, {-2, 0}, {+1, +2}, {-2, -1} }, // 2->R S3
-    { {0, 0}, {+2, 0}, {-1, 0}, {+2, -1}, {-1, +2} }, // 2->L S4
-    { {0, 0}, {-2, 0}, {+1, 0}, {-2, +1}, {+1, -2} }, // L->2 S5
-    { {0, 0}, {+1, 0}, {-2, 0}, {+1, +2}, {-2, -1} }, // L->0 S6
-    { {0, 0}, {-1, 0}, {+2, 0}, {-1, -2}, {+2, +1} }  // 0->L S7
-};
+#include <cstdint>
+#include <algorithm>
 
 struct TetrominoRotationData {
-  TetrominoRotationData() : shape_(std::vector<std::vector<int>>()) {}
-
-  explicit TetrominoRotationData(const std::vector<std::vector<int>>& shape) : shape_(shape) {}
-
-  TetrominoRotationData(int angle_index, const std::vector<std::vector<int>>& shape) :
-      angle_index_(angle_index), shape_(shape) {}
-
-  TetrominoRotationData(int width, int height, const std::vector<std::vector<int>>& shape) :
-      width_(width), height_(height), shape_(shape) {}
-
-  TetrominoRotationData(int angle_index, int width, int height, const std::vector<std::vector<int>>& shape) :
-      angle_index_(angle_index), width_(width), height_(height), shape_(shape) {}
+  static constexpr int kShapeSize = 4;
+
+  using Shape = std::array<std::array<int, kShapeSize>, kShapeSize>;
+  // One bit per occupied column for each shape row, bit 0 is the leftmost column of the shape
+  using Masks = std::array<uint8_t, kShapeSize>;
+
+  constexpr TetrominoRotationData() = default;
+
+  template <int R, int C>
+  constexpr explicit TetrominoRotationData(const int (&shape)[R][C]) : TetrominoRotationData(-1, 0, 0, shape) {}
+
+  template <int R, int C>
+  constexpr TetrominoRotationData(int angle_index, const int (&shape)[R][C]) : TetrominoRotationData(angle_index, 0, 0, shape) {}
+
+  template <int R, int C>
+  constexpr TetrominoRotationData(int width, int height, const int (&shape)[R][C]) : TetrominoRotationData(-1, width, height, shape) {}
+
+  template <int R, int C>
+  constexpr TetrominoRotationData(int angle_index, int width, int height, const int (&shape)[R][C]) :
+      angle_index_(angle_index), width_(width), height_(height), size_(std::max(R, C)) {
+    static_assert(R <= kShapeSize && C <= kShapeSize, "Shape does not fit in the rotation table");
+
+    for (int row = 0; row < R; ++row) {
+      for (int col = 0; col < C; ++col) {
+        shape_[row][col] = shape[row][col];
+        if (0 == shape[row][col]) {
+          continue;
+        }
+        masks_[row] |= static_cast<uint8_t>(1 << col);
+        id_ = (0 == id_) ? shape[row][col] : id_;
+        first_row_ = std::min(first_row_, row);
+        last_row_ = std::max(last_row_, row);
+        first_col_ = std::min(first_col_, col);
+        last_col_ = std::max(last_col_, col);
+        top_profile_[col] = (top_profile_[col] < 0) ? row : top_profile_[col];
+        bottom_profile_[col] = row;
+      }
+    }
+  }
 
   int angle_index_ = -1;
   int width_ = 0;
   int height_ = 0;
-  std::vector<std::vector<int>> shape_;
+  int size_ = 0;
+  Shape shape_ {};
+  Masks masks_ {};
+  int id_ = 0;
+  // Bounding box of the occupied cells, last_row_ is the lowest occupied row of the shape
+  int first_row_ = kShapeSize;
+  int last_row_ = -1;
+  int first_col_ = kShapeSize;
+  int last_col_ = -1;
+  // Highest and lowest occupied row of every shape column, -1 if the column is empty
+  std::array<int, kShapeSize> top_profile_ { -1, -1, -1, -1 };
+  std::array<int, kShapeSize> bottom_profile_ { -1, -1, -1, -1 };
 };
 
+using TetrominoRotations = std::array<TetrominoRotationData, 4>;
+
 // I Tetromino 1
 
-const TetrominoRotationData kTetrominoRotationShape_I_0D(kMinoWidth * 4, kMinoHeight, {
+constexpr TetrominoRotationData kTetrominoRotationShape_I_0D(kMinoWidth * 4, kMinoHeight, {
     {0, 0, 0, 0},
     {1, 1, 1, 1},
     {0, 0, 0, 0},
     {0, 0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_I_90D({
+constexpr TetrominoRotationData kTetrominoRotationShape_I_90D({
     {0, 0, 1, 0},
     {0, 0, 1, 0},
     {0, 0, 1, 0},
     {0, 0, 1, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_I_180D({
+constexpr TetrominoRotationData kTetrominoRotationShape_I_180D({
     {0, 0, 0, 0},
     {0, 0, 0, 0},
     {1, 1, 1, 1},
     {0, 0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_I_270D({
+constexpr TetrominoRotationData kTetrominoRotationShape_I_270D({
     {0, 1, 0, 0},
     {0, 1, 0, 0},
     {0, 1, 0, 0},
     {0, 1, 0, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_I_Rotations = {
+constexpr TetrominoRotations kTetromino_I_Rotations = {
   kTetrominoRotationShape_I_0D,
   kTetrominoRotationShape_I_90D,
   kTetrominoRotationShape_I_180D,
@@ -94,31 +106,31 @@ const std::vector<TetrominoRotationData> kTetromino_I_Rotations = {
 
 // J Tetromino 2
 
-const TetrominoRotationData kTetrominoRotationShape_J_0D(kMinoWidth * 3, kMinoHeight * 2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_J_0D(kMinoWidth * 3, kMinoHeight * 2, {
     {2, 0, 0},
     {2, 2, 2},
     {0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_J_90D({
+constexpr TetrominoRotationData kTetrominoRotationShape_J_90D({
     {0, 2, 2},
     {0, 2, 0},
     {0, 2, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_J_180D({
+constexpr TetrominoRotationData kTetrominoRotationShape_J_180D({
     {0, 0, 0},
     {2, 2, 2},
     {0, 0, 2}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_J_270D({
+constexpr TetrominoRotationData kTetrominoRotationShape_J_270D({
     {0, 2, 0},
     {0, 2, 0},
     {2, 2, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_J_Rotations = {
+constexpr TetrominoRotations kTetromino_J_Rotations = {
   kTetrominoRotationShape_J_0D,
   kTetrominoRotationShape_J_90D,
   kTetrominoRotationShape_J_180D,
@@ -127,31 +139,31 @@ const std::vector<TetrominoRotationData> kTetromino_J_Rotations = {
 
 // L Tetromino 3
 
-const TetrominoRotationData kTetrominoRotationShape_L_0D(kMinoWidth * 3, kMinoHeight * 2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_L_0D(kMinoWidth * 3, kMinoHeight * 2, {
     {0, 0, 3},
     {3, 3, 3},
     {0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_L_90D({
+constexpr TetrominoRotationData kTetrominoRotationShape_L_90D({
     {0, 3, 0},
     {0, 3, 0},
     {0, 3, 3}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_L_180D({
+constexpr TetrominoRotationData kTetrominoRotationShape_L_180D({
     {0, 0, 0},
     {3, 3, 3},
     {3, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_L_270D({
+constexpr TetrominoRotationData kTetrominoRotationShape_L_270D({
     {3, 3, 0},
     {0, 3, 0},
     {0, 3, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_L_Rotations = {
+constexpr TetrominoRotations kTetromino_L_Rotations = {
   kTetrominoRotationShape_L_0D,
   kTetrominoRotationShape_L_90D,
   kTetrominoRotationShape_L_180D,
@@ -160,13 +172,13 @@ const std::vector<TetrominoRotationData> kTetromino_L_Rotations = {
 
 // O Tetromino 4
 
-const TetrominoRotationData kTetrominoRotationShape_O(kMinoWidth * 4, kMinoHeight * 2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_O(kMinoWidth * 4, kMinoHeight * 2, {
     {0, 4, 4, 0},
     {0, 4, 4, 0},
     {0, 0, 0, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_O_Rotations = {
+constexpr TetrominoRotations kTetromino_O_Rotations = {
   kTetrominoRotationShape_O,
   kTetrominoRotationShape_O,
   kTetrominoRotationShape_O,
@@ -175,31 +187,31 @@ const std::vector<TetrominoRotationData> kTetromino_O_Rotations = {
 
 // S Tetromino 5
 
-const TetrominoRotationData kTetrominoRotationShape_S_0D(kMinoWidth * 3, kMinoHeight * 2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_S_0D(kMinoWidth * 3, kMinoHeight * 2, {
     {0, 5, 5},
     {5, 5, 0},
     {0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_S_90D({
+constexpr TetrominoRotationData kTetrominoRotationShape_S_90D({
     {0, 5, 0},
     {0, 5, 5},
     {0, 0, 5}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_S_180D({
+constexpr TetrominoRotationData kTetrominoRotationShape_S_180D({
     {0, 0, 0},
     {0, 5, 5},
     {5, 5, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_S_270D({
+constexpr TetrominoRotationData kTetrominoRotationShape_S_270D({
     {5, 0, 0},
     {5, 5, 0},
     {0, 5, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_S_Rotations = {
+constexpr TetrominoRotations kTetromino_S_Rotations = {
   kTetrominoRotationShape_S_0D,
   kTetrominoRotationShape_S_90D,
   kTetrominoRotationShape_S_180D,
@@ -208,31 +220,31 @@ const std::vector<TetrominoRotationData> kTetromino_S_Rotations = {
 
 // T Tetromino 6
 
-const TetrominoRotationData kTetrominoRotationShape_T_0D(0, kMinoWidth * 3, kMinoHeight * 2,  {
+constexpr TetrominoRotationData kTetrominoRotationShape_T_0D(0, kMinoWidth * 3, kMinoHeight * 2,  {
     {0, 6, 0},
     {6, 6, 6},
     {0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_T_90D(1, {
+constexpr TetrominoRotationData kTetrominoRotationShape_T_90D(1, {
     {0, 6, 0},
     {0, 6, 6},
     {0, 6, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_T_180D(2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_T_180D(2, {
     {0, 0, 0},
     {6, 6, 6},
     {0, 6, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_T_270D(3, {
+constexpr TetrominoRotationData kTetrominoRotationShape_T_270D(3, {
     {0, 6, 0},
     {6, 6, 0},
     {0, 6, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_T_Rotations = {
+constexpr TetrominoRotations kTetromino_T_Rotations = {
   kTetrominoRotationShape_T_0D,
   kTetrominoRotationShape_T_90D,
   kTetrominoRotationShape_T_180D,
@@ -241,35 +253,35 @@ const std::vector<TetrominoRotationData> kTetromino_T_Rotations = {
 
 // Z Tetromino 7
 
-const TetrominoRotationData kTetrominoRotationShape_Z_0D(kMinoWidth * 3, kMinoHeight * 2, {
+constexpr TetrominoRotationData kTetrominoRotationShape_Z_0D(kMinoWidth * 3, kMinoHeight * 2, {
     {7, 7, 0},
     {0, 7, 7},
     {0, 0, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_Z_90D({
+constexpr TetrominoRotationData kTetrominoRotationShape_Z_90D({
     {0, 0, 7},
     {0, 7, 7},
     {0, 7, 0}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_Z_180D({
+constexpr TetrominoRotationData kTetrominoRotationShape_Z_180D({
     {0, 0, 0},
     {7, 7, 0},
     {0, 7, 7}
   });
 
-const TetrominoRotationData kTetrominoRotationShape_Z_270D({
+constexpr TetrominoRotationData kTetrominoRotationShape_Z_270D({
     {0, 7, 0},
     {7, 7, 0},
     {7, 0, 0}
   });
 
-const std::vector<TetrominoRotationData> kTetromino_Z_Rotations = {
+constexpr TetrominoRotations kTetromino_Z_Rotations = {
   kTetrominoRotationShape_Z_0D,
   kTetrominoRotationShape_Z_90D,
   kTetrominoRotationShape_Z_180D,
   kTetrominoRotationShape_Z_270D
 };
 
-const std::vector<TetrominoRotationData> kTetromino_No_Rotations = {};
+constexpr TetrominoRotations kTetromino_No_Rotations = {};
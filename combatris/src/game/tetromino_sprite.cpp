@@ -1,6 +1,7 @@
 #include "game/tetromino_sprite.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <cassert>
 
 namespace {
 
@@ -9,19 +10,6 @@ const int kResetsAllowed = 15;
 using Angle = Tetromino::Angle;
 using Rotation = TetrominoSprite::Rotation;
 
-const std::unordered_map<Tetromino::Angle, const std::unordered_map<Tetromino::Angle, int>> kStates = {
-  { Angle::A0, { { Angle::A90, 0 }, { Angle::A270, 7 } } },
-  { Angle::A90, { { Angle::A180, 2 }, { Angle::A0, 1 } } },
-  { Angle::A180, { { Angle::A270, 4 }, { Angle::A90, 3 } } },
-  { Angle::A270, { { Angle::A0, 6 }, { Angle::A180 , 5 } } }
-};
-
-inline const std::vector<std::vector<int>>& GetWallKickData(Tetromino::Type type, Tetromino::Angle from_angle, Tetromino::Angle to_angle) {
-  auto state = kStates.at(from_angle).at(to_angle);
-
-  return (Tetromino::Type::I == type) ? kWallKickDataForI[state] : kWallKickDataForJLSTZ[state];
-}
-
 Tetromino::Angle GetNextAngle(Tetromino::Angle current_angle, Rotation rotate) {
   auto angle= static_cast<int>(current_angle);
 
@@ -45,41 +33,59 @@ void TetrominoSprite::ResetDelayCounter() {
   }
 }
 
-std::optional<std::pair<Position, Tetromino::Angle>> TetrominoSprite::TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate) {
+std::optional<std::tuple<Position, Tetromino::Angle, int>> TetrominoSprite::TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate) {
   if (Tetromino::Type::O == type) {
     return {};
   }
-  enum { GetX = 0, GetY = 1 };
+  switch (rotation_system_) {
+    case RotationSystemType::SRSPlus:
+      return TryRotation<SRSPlus>(type, current_pos, current_angle, rotate);
+    case RotationSystemType::ARS:
+      return TryRotation<ARS>(type, current_pos, current_angle, rotate);
+    default:
+      return TryRotation<SRS>(type, current_pos, current_angle, rotate);
+  }
+}
 
-  auto try_angle = GetNextAngle(current_angle, rotate);
+template <typename RotationSystem>
+std::optional<std::tuple<Position, Tetromino::Angle, int>> TetrominoSprite::TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate) {
+  const auto try_angle = GetNextAngle(current_angle, rotate);
+  const auto state = RotationState(current_angle, Rotation::Clockwise == rotate);
 
-  const auto& rotation_data = tetromino_.GetRotationData(try_angle);
-  const auto& wallkick_data = GetWallKickData(type, current_angle, try_angle);
+  if (Tetromino::Type::I == type) {
+    return TryKicks(RotationSystem::kI[state], current_pos, try_angle);
+  }
+  return TryKicks(RotationSystem::kJLSTZ[state], current_pos, try_angle);
+}
+
+template <size_t Tests>
+std::optional<std::tuple<Position, Tetromino::Angle, int>> TetrominoSprite::TryKicks(const KickTests<Tests>& kicks, const Position& current_pos, Tetromino::Angle try_angle) {
+  const auto& rotation_data = tetromino_->GetRotationData(try_angle);
 
-  for (const auto& offsets : wallkick_data) {
-    Position try_pos(current_pos.row() + offsets[GetY], current_pos.col() + offsets[GetX]);
+  for (int kick = 0; kick < static_cast<int>(Tests); ++kick) {
+    Position try_pos(current_pos.row() + kicks[kick].row_, current_pos.col() + kicks[kick].col_);
 
     if (matrix_->IsValid(try_pos, rotation_data)) {
       ResetDelayCounter();
-      return std::make_optional(std::make_pair(try_pos, try_angle));
+      return std::make_optional(std::make_tuple(try_pos, try_angle, kick));
     }
   }
   return {};
 }
 
 void TetrominoSprite::RotateClockwise() {
-  if (auto result = TryRotation(tetromino_.type(), pos_, angle_, Rotation::Clockwise)) {
-    std::tie(pos_, angle_) = *result;
-    rotation_data_ = tetromino_.GetRotationData(angle_);
+  if (auto result = TryRotation(tetromino_->type(), pos_, angle_, Rotation::Clockwise)) {
+    std::tie(pos_, angle_, last_kick_) = *result;
+    rotation_data_ = tetromino_->GetRotationData(angle_);
     matrix_->Insert(pos_, rotation_data_);
     last_move_ = Tetromino::Move::Rotation;
   }
 }
 
 void TetrominoSprite::RotateCounterClockwise() {
-  if (auto result = TryRotation(tetromino_.type(), pos_, angle_, Rotation::CounterClockwise)) {
-    std::tie(pos_, angle_) = *result;
-    rotation_data_ = tetromino_.GetRotationData(angle_);
+  if (auto result = TryRotation(tetromino_->type(), pos_, angle_, Rotation::CounterClockwise)) {
+    std::tie(pos_, angle_, last_kick_) = *result;
+    rotation_data_ = tetromino_->GetRotationData(angle_);
     matrix_->Insert(pos_, rotation_data_);
     last_move_ = Tetromino::Move::Rotation;
   }
@@ -92,17 +98,17 @@ void TetrominoSprite::SoftDrop() {
   if (pos_.row() >= kMatrixFirstRow - kSkylineOffset) {
     events_.Push(Event::Type::DropScoreData, 1);
   }
-  level_->Release();
+  level_->SoftDrop();
 }
 
 void TetrominoSprite::HardDrop() {
   if (State::OnFloor == state_) {
-    state_ = State::Commit;
+    SetState(State::Commit);
     return;
   }
   auto drop_row = pos_.row();
 
-  state_ = State::Commit;
+  SetState(State::Commit);
   pos_ = matrix_->GetDropPosition(pos_, rotation_data_);
   level_->Release();
 
@@ -128,51 +134,67 @@ void TetrominoSprite::Right() {
   }
 }
 
+void TetrominoSprite::ShiftToWall(int direction) {
+  if (const auto pos = matrix_->GetWallPosition(pos_, rotation_data_, direction); pos != pos_) {
+    pos_ = pos;
+    matrix_->Insert(pos_, rotation_data_);
+    last_move_ = (direction < 0) ? Tetromino::Move::Left : Tetromino::Move::Right;
+    ResetDelayCounter();
+  }
+}
+
 TetrominoSprite::State TetrominoSprite::Down(double delta_time) {
   switch (state_) {
     case State::Falling:
     case State::Generated:
-      last_move_ = Tetromino::Move::Down;
-      if (level_->WaitForMoveDown(delta_time)) {
+      {
+        const auto drop_row = matrix_->GetDropPosition(pos_, rotation_data_).row();
+        const auto rows = level_->WaitForMoveDown(delta_time, drop_row - pos_.row());
+
+        last_move_ = Tetromino::Move::Down;
+        if (0 == rows) {
+          break;
+        }
         if (reset_delay_counter_ >= kResetsAllowed) {
-          state_ = State::Commit;
-        } else if (matrix_->IsValid(Position(pos_.row() + 1, pos_.col()), rotation_data_)) {
-          pos_.inc_row();
+          SetState(State::Commit);
+        } else if (drop_row > pos_.row()) {
+          // At high gravity several rows can be passed in one step, the tetromino stops on the stack
+          pos_ = Position(std::min(pos_.row() + rows, drop_row), pos_.col());
           matrix_->Insert(pos_, rotation_data_);
           if (State::Generated == state_) {
-            state_ = State::Falling;
+            SetState(State::Falling);
             events_.Push(Event::Type::BattleNextTetrominoSuccessful);
           }
-          if (!matrix_->IsValid(Position(pos_.row() + 1, pos_.col()), rotation_data_)) {
+          if (pos_.row() == drop_row) {
             events_.Push(Event::Type::OnFloor, Events::QueueRule::NoDuplicates);
-            state_ = State::OnFloor;
+            SetState(State::OnFloor);
           }
         } else {
           events_.Push(Event::Type::OnFloor, Events::QueueRule::NoDuplicates);
-          state_ = State::OnFloor;
+          SetState(State::OnFloor);
         }
       }
       break;
     case State::OnFloor:
       if (level_->WaitForLockDelay(delta_time)) {
-        state_ = State::Commit;
+        SetState(State::Commit);
         if (matrix_->IsAboveSkyline(pos_, rotation_data_)) {
-          state_ = (got_lines_) ? State::KO : State::GameOver;
+          SetState((got_lines_) ? State::KO : State::GameOver);
         }
       } else if (matrix_->IsValid(Position(pos_.row() + 1, pos_.col()), rotation_data_)) {
         events_.Push(Event::Type::ClearOnFloor, Events::QueueRule::NoDuplicates);
-        state_ = State::Falling;
+        SetState(State::Falling);
       }
       break;
     case State::Commit:
       {
-        auto [lines_cleared, tspin_type, perfect_clear] = matrix_->Commit(tetromino_.type(), last_move_, pos_, rotation_data_);
+        auto [lines_cleared, tspin_type, perfect_clear] = matrix_->Commit(tetromino_->type(), last_move_, pos_, rotation_data_, last_kick_);
 
         if (perfect_clear) {
           events_.Push(Event::Type::PerfectClear);
         }
         events_.Push(Event::Type::ClearedLinesScoreData, lines_cleared, pos_, tspin_type);
-        state_ = State::Commited;
+        SetState(State::Commited);
       }
       break;
     default:
@@ -180,3 +202,24 @@ TetrominoSprite::State TetrominoSprite::Down(double delta_time) {
   }
   return state_;
 }
+
+void TetrominoSprite::Capture(GameStateSnapshot& snapshot) const {
+  snapshot.sprite_ = { tetromino_->type(), pos_, angle_, last_move_, last_kick_, reset_delay_counter_, static_cast<int>(state_), got_lines_ };
+}
+
+void TetrominoSprite::Restore(const GameStateSnapshot& snapshot) {
+  const auto& sprite = snapshot.sprite_;
+
+  assert(sprite.type_ == tetromino_->type());
+  pos_ = sprite.pos_;
+  angle_ = sprite.angle_;
+  rotation_data_ = tetromino_->GetRotationData(angle_);
+  last_move_ = sprite.last_move_;
+  last_kick_ = sprite.last_kick_;
+  reset_delay_counter_ = sprite.reset_delay_counter_;
+  SetState(static_cast<State>(sprite.state_));
+  got_lines_ = sprite.got_lines_;
+  if (State::Generated == state_ || State::Falling == state_ || State::OnFloor == state_) {
+    matrix_->Insert(pos_, rotation_data_);
+  }
+}
@@ -2,6 +2,7 @@
 
 #include "game/matrix.h"
 #include "game/panes/level.h"
+#include "game/rotation_system.h"
 
 #include <optional>
 
@@ -19,13 +20,26 @@ class TetrominoSprite {
 
   TetrominoSprite(const Tetromino& tetromino, const std::shared_ptr<Level>& level, Events& events,
                   const std::shared_ptr<Matrix>& matrix)
-      : tetromino_(tetromino), level_(level), events_(events), matrix_(matrix) {}
+      : tetromino_(&tetromino), level_(level), events_(events), matrix_(matrix) {}
+
+  // Sprites are reused, a sprite is reset to a new tetromino at the spawn position before it is generated
+  void Reset(const Tetromino& tetromino, RotationSystemType rotation_system) {
+    tetromino_ = &tetromino;
+    rotation_system_ = rotation_system;
+    angle_ = kSpawnAngle;
+    pos_ = kSpawnPosition;
+    last_move_ = Tetromino::Move::None;
+    last_kick_ = -1;
+    reset_delay_counter_ = 0;
+    got_lines_ = false;
+    SetState(State::Generated);
+  }
 
   State Generate(bool got_lines) {
     got_lines_ = got_lines;
-    rotation_data_ = tetromino_.GetRotationData(kSpawnAngle);
+    rotation_data_ = tetromino_->GetRotationData(kSpawnAngle);
     if (!matrix_->IsValid(pos_, rotation_data_)) {
-      state_ = (got_lines_) ? State::KO : State::GameOver;
+      SetState((got_lines_) ? State::KO : State::GameOver);
     } else {
       matrix_->Insert(pos_, rotation_data_);
       level_->Release();
@@ -37,10 +51,10 @@ class TetrominoSprite {
   void Render(const std::shared_ptr<SDL_Texture>& texture) const {
     const Position adjusted_pos(pos_.row() - kMatrixFirstRow, pos_.col() - kMatrixFirstCol);
 
-    tetromino_.Render(adjusted_pos.x(), adjusted_pos.y(), texture.get(), angle_);
+    tetromino_->Render(adjusted_pos.x(), adjusted_pos.y(), texture.get(), angle_);
   }
 
-  inline const Tetromino& tetromino() const { return tetromino_; }
+  inline const Tetromino& tetromino() const { return *tetromino_; }
 
   inline State state() const { return state_; }
 
@@ -58,8 +72,16 @@ class TetrominoSprite {
 
   void Right();
 
+  // Left or right until the tetromino hits the wall or the stack, used when the auto repeat rate is 0
+  void ShiftToWall(int direction);
+
   State Down(double delta_time);
 
+  void Capture(GameStateSnapshot& snapshot) const;
+
+  // The sprite must be of the captured type, restore the matrix first
+  void Restore(const GameStateSnapshot& snapshot);
+
   bool Update() {
     if (!matrix_->IsValid(pos_, rotation_data_)) {
       return false;
@@ -72,10 +94,23 @@ class TetrominoSprite {
  protected:
   void ResetDelayCounter();
 
-  std::optional<std::pair<Position, Tetromino::Angle>> TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate);
+  // Every state transition goes to the trace, with the type and position of the tetromino
+  void SetState(State state) {
+    utility::Trace::Record(utility::TraceKind::SpriteState, static_cast<uint8_t>(state), static_cast<int32_t>(tetromino_->type()),
+                           (static_cast<uint64_t>(pos_.row()) << 32) | static_cast<uint32_t>(pos_.col()));
+    state_ = state;
+  }
+
+  std::optional<std::tuple<Position, Tetromino::Angle, int>> TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate);
+
+  template <typename RotationSystem>
+  std::optional<std::tuple<Position, Tetromino::Angle, int>> TryRotation(Tetromino::Type type, const Position& current_pos, Tetromino::Angle current_angle, Rotation rotate);
+
+  template <size_t Tests>
+  std::optional<std::tuple<Position, Tetromino::Angle, int>> TryKicks(const KickTests<Tests>& kicks, const Position& current_pos, Tetromino::Angle try_angle);
 
  private:
-  const Tetromino& tetromino_;
+  const Tetromino* tetromino_;
   std::shared_ptr<Level> level_;
   Events& events_;
   std::shared_ptr<Matrix> matrix_;
@@ -83,6 +118,8 @@ class TetrominoSprite {
   Tetromino::Angle angle_ = kSpawnAngle;
   Position pos_ = kSpawnPosition;
   Tetromino::Move last_move_ = Tetromino::Move::None;
+  int last_kick_ = -1;
+  RotationSystemType rotation_system_ = RotationSystemType::SRS;
   int reset_delay_counter_ = 0;
   bool got_lines_ = false;
   State state_ = State::Generated;
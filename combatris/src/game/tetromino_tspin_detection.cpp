@@ -2,62 +2,61 @@
 
 namespace {
 
-const int kTSpinCorner = 1;
-const int kTSpinMiniCorner = 2;
-
-const TetrominoRotationData kTSpinShape_0D({
-    {1, 6, 1},
-    {6, 6, 6},
-    {2, 0, 2}
-  });
-
-const TetrominoRotationData kTSpinShape_90D({
-    {2, 6, 1},
-    {0, 6, 6},
-    {2, 6, 1}
-  });
-
-const TetrominoRotationData kTSpinShape_180D({
-    {2, 0, 2},
-    {6, 6, 6},
-    {1, 6, 1}
-  });
-
-const TetrominoRotationData kTSpinShape_270D({
-    {1, 6, 2},
-    {6, 6, 0},
-    {1, 6, 2}
-  });
-
-const std::vector<TetrominoRotationData> kTSpin_Rotations = {
-  kTSpinShape_0D,
-  kTSpinShape_90D,
-  kTSpinShape_180D,
-  kTSpinShape_270D
+// The corners of the 3x3 box around the T as bits, bit 0 is top left, 1 top right, 2 bottom left and
+// 3 bottom right. The front corners are on the side the T points to.
+struct TSpinCorners {
+  int front_;
+  int back_;
 };
 
-} // namespace
+constexpr std::array<TSpinCorners, 4> kTSpinCorners = {{
+  { 0b0011, 0b1100 }, // 0D
+  { 0b1010, 0b0101 }, // 90D
+  { 0b1100, 0b0011 }, // 180D
+  { 0b0101, 0b1010 }  // 270D
+}};
+
+using TSpinTable = std::array<std::array<TSpinType, 16>, 4>;
+
+constexpr TSpinTable MakeTSpinTable() {
+  TSpinTable table {};
+
+  for (size_t angle = 0; angle < table.size(); ++angle) {
+    for (unsigned corners = 0; corners < 16; ++corners) {
+      const auto front = std::popcount(corners & kTSpinCorners[angle].front_);
+      const auto back = std::popcount(corners & kTSpinCorners[angle].back_);
+
+      if (2 == front && back >= 1) {
+        table[angle][corners] = TSpinType::TSpin;
+      } else if (1 == front && back >= 2) {
+        table[angle][corners] = TSpinType::TSpinMini;
+      } else {
+        table[angle][corners] = TSpinType::None;
+      }
+    }
+  }
+  return table;
+}
 
-TSpinType DetectTSpin(const Matrix::Type& matrix, const Position& pos, int angle_index) {
-  const auto& shape = kTSpin_Rotations.at(angle_index).shape_;
-  auto tspin_corners = 0;
-  auto tspin_minicorners = 0;
+constexpr TSpinTable kTSpinTable = MakeTSpinTable();
 
-  for (int row = 0; row < static_cast<int>(shape.size()); ++row) {
-    for (int col  = 0; col < static_cast<int>(shape.at(row).size()); ++col) {
-      const auto elem = matrix.at(pos.row() + row).at(pos.col() + col);
+} // namespace
 
-      tspin_corners += (kTSpinCorner == shape.at(row).at(col) && elem != kEmptyID && elem != kBombID);
-      tspin_minicorners += (kTSpinMiniCorner == shape.at(row).at(col) && elem != kEmptyID && elem != kBombID);
-    }
-  }
-  auto tspin_type = TSpinType::None;
+TSpinType DetectTSpin(const Board& board, const Position& pos, int angle_index, int last_kick) {
+  const auto top = board.row(pos.row()) >> pos.col();
+  const auto bottom = board.row(pos.row() + 2) >> pos.col();
+  const auto corners = (top & 0b1) | ((top >> 1) & 0b10) | ((bottom << 2) & 0b100) | ((bottom << 1) & 0b1000);
+  const auto tspin_type = kTSpinTable[angle_index][corners];
 
-  if (2 == tspin_corners && tspin_minicorners >= 1) {
-    tspin_type = TSpinType::TSpin;
-  } else if (1 == tspin_corners && tspin_minicorners >= 2) {
-    tspin_type = TSpinType::TSpinMini;
+  if (TSpinType::TSpinMini == tspin_type && kTSpinUpgradeKick == last_kick) {
+    return TSpinType::TSpin;
   }
-
   return tspin_type;
 }
+
+bool IsImmobile(const Board& board, const Position& pos, const TetrominoRotationData& rotation_data) {
+  return !board.IsValid(Position(pos.row() - 1, pos.col()), rotation_data) &&
+      !board.IsValid(Position(pos.row() + 1, pos.col()), rotation_data) &&
+      !board.IsValid(Position(pos.row(), pos.col() - 1), rotation_data) &&
+      !board.IsValid(Position(pos.row(), pos.col() + 1), rotation_data);
+}
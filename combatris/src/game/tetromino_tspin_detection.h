@@ -1,5 +1,15 @@
 #pragma once
 
-#include "game/matrix.h"
+#include "game/board.h"
+#include "game/events.h"
+#include "game/rotation_system.h"
 
-TSpinType DetectTSpin(const Matrix::Type& matrix, const Position& pos, int angle_index);
+// A T-spin mini placed by the SRS "TST" kick counts as a T-spin. SRS+ shares the table, ARS never gets that far.
+const int kTSpinUpgradeKick = SRS::kTSpinUpgradeKick;
+
+// last_kick is the index of the wall kick test that placed the tetromino on its last rotation: 0 if it rotated
+// without kicking, -1 if it has not rotated since it spawned
+TSpinType DetectTSpin(const Board& board, const Position& pos, int angle_index, int last_kick = -1);
+
+// A tetromino that can't move up, down, left or right after a rotation is an all-spin
+bool IsImmobile(const Board& board, const Position& pos, const TetrominoRotationData& rotation_data);
@@ -1,4 +1,5 @@
 #include "network/multiplayer_controller.h"
+#include "utility/trace.h"
 
 #include <iostream>
 #include <deque>
@@ -75,6 +76,7 @@ void MultiPlayerController::Dispatch() {
     const auto host_id = response.host_id_;
     const auto& payload = response.payload_;
 
+    utility::Trace::Record(utility::TraceKind::NetworkReceive, response.request_, 0, host_id);
     switch (response.request_) {
       case Request::Join:
         if (listener_if_->GotJoin(host_name, host_id)) {
@@ -147,6 +149,7 @@ void MultiPlayerController::Run() {
       time_since_last_package = utility::time_in_ms();
 
       package.header_.SetSeqenceNr(sequence_nr_reliable);
+      utility::Trace::Record(utility::TraceKind::NetworkSend, package.header_.request(), static_cast<int32_t>(sequence_nr_reliable));
       sequence_nr_reliable++;
       if (sliding_window.size() == kWindowSize) {
         sliding_window.pop_back();
@@ -161,6 +164,7 @@ void MultiPlayerController::Run() {
       auto& package = outgoing_package.progress_package_;
 
       package.header_.SetSeqenceNr(sequence_nr_unreliable);
+      utility::Trace::Record(utility::TraceKind::NetworkSend, package.header_.request(), static_cast<int32_t>(sequence_nr_unreliable));
       sequence_nr_unreliable++;
 
       UnreliablePackage unreliable_package(client.host_name(), client.host_id(), package);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace utility {
+
+// Auto repeat of the held control driven by the input event timestamps. Update returns every repeat that was
+// due since the previous call, so slow frames delay repeats but never lose them. All times are in milliseconds.
+template <typename Control>
+class AutoRepeat final {
+ public:
+  // Returned by Update when ARR is 0 and DAS has elapsed, the control should be applied until it has no effect
+  static constexpr int kRepeatToWall = -1;
+  // Repeats due after a stall (window moved, debugger) are dropped above this
+  static constexpr int kMaxRepeats = 64;
+  static constexpr int64_t kSoftDropInterval = 50;
+
+  AutoRepeat(Control none, Control soft_drop, int64_t das, int64_t arr, int soft_drop_factor)
+      : none_(none), soft_drop_(soft_drop), control_(none) { Set(das, arr, soft_drop_factor); }
+
+  void Set(int64_t das, int64_t arr, int soft_drop_factor) {
+    das_ = std::max<int64_t>(das, 0);
+    arr_ = std::max<int64_t>(arr, 0);
+    soft_drop_interval_ = std::max<int64_t>(kSoftDropInterval / std::max(soft_drop_factor, 1), 1);
+  }
+
+  // The press itself is handled by the caller, soft drop repeats without DAS
+  void Press(Control control, int64_t timestamp) {
+    control_ = control;
+    next_ = timestamp + ((soft_drop_ == control) ? soft_drop_interval_ : das_);
+  }
+
+  void Release(Control control) {
+    if (control == control_) {
+      control_ = none_;
+    }
+  }
+
+  void Reset() { control_ = none_; }
+
+  inline Control control() const { return control_; }
+
+  // Number of repeats of control() due at time now, or kRepeatToWall
+  int Update(int64_t now) {
+    if (none_ == control_ || now < next_) {
+      return 0;
+    }
+    const auto interval = (soft_drop_ == control_) ? soft_drop_interval_ : arr_;
+
+    if (0 == interval) {
+      return kRepeatToWall;
+    }
+    const auto repeats = (now - next_) / interval + 1;
+
+    next_ += repeats * interval;
+
+    return static_cast<int>(std::min<int64_t>(repeats, kMaxRepeats));
+  }
+
+ private:
+  Control none_;
+  Control soft_drop_;
+  Control control_;
+  int64_t das_ = 0;
+  int64_t arr_ = 0;
+  int64_t soft_drop_interval_ = kSoftDropInterval;
+  int64_t next_ = 0;
+};
+
+} // namespace utility
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "utility/timer.h"
+
+#include <SDL.h>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace utility {
+
+// Polls SDL and timestamps keyboard and game controller button events with the monotonic nanosecond clock.
+// SDL2 only reads devices on the thread that created the window, so rather than an input thread the game loop
+// polls before the simulation step and again between simulation and render. A slow render then holds back a
+// key press by at most the render itself instead of a whole frame.
+//
+// A key was pressed somewhere between the poll before the one that picked it up and that poll, latency is
+// measured from the earlier one to the game acting on the event, the worst case.
+class InputCapture final {
+ public:
+  struct TimedEvent {
+    SDL_Event event_;
+    int64_t timestamp_; // nanoseconds, when the event was picked up
+    int64_t earliest_; // nanoseconds, when the previous poll started
+  };
+
+  InputCapture() = default;
+
+  InputCapture(const InputCapture&) = delete;
+
+  static bool IsInput(const SDL_Event& event) {
+    switch (event.type) {
+      case SDL_KEYDOWN:
+      case SDL_KEYUP:
+      case SDL_CONTROLLERBUTTONDOWN:
+      case SDL_CONTROLLERBUTTONUP:
+        return true;
+    }
+    return false;
+  }
+
+  // Starts a poll, call Poll until it returns false
+  void Begin() {
+    const auto now = time_in_ns();
+
+    previous_poll_ = (current_poll_ > 0) ? current_poll_ : now;
+    current_poll_ = now;
+  }
+
+  // The next event of any type
+  bool Poll(TimedEvent& timed_event) {
+    if (!SDL_PollEvent(&timed_event.event_)) {
+      return false;
+    }
+    timed_event.timestamp_ = time_in_ns();
+    timed_event.earliest_ = previous_poll_;
+
+    return true;
+  }
+
+  // Called when the game has acted on an input event
+  void Applied(const TimedEvent& timed_event) {
+    const auto latency = time_in_ns() - timed_event.earliest_;
+
+    ++count_;
+    total_latency_ += latency;
+    max_latency_ = std::max(max_latency_, latency);
+  }
+
+  inline int64_t average_latency() const { return (count_ > 0) ? total_latency_ / count_ : 0; }
+
+  inline int64_t max_latency() const { return max_latency_; }
+
+  void ReportLatency(std::ostream& os) const {
+    os << std::fixed << std::setprecision(2) << "Input latency: average " << average_latency() / 1000000.0 << " ms, max "
+       << max_latency() / 1000000.0 << " ms over " << count_ << " events" << std::endl;
+  }
+
+ private:
+  int64_t previous_poll_ = 0;
+  int64_t current_poll_ = 0;
+  int64_t count_ = 0;
+  int64_t total_latency_ = 0;
+  int64_t max_latency_ = 0;
+};
+
+} // namespace utility
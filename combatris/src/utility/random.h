@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace utility {
+
+// SplitMix64, a small generator with the whole state in one word so it is cheap to copy and snapshot.
+// Bounded values are computed here rather than with std::uniform_int_distribution, the standard
+// distributions differ between standard libraries and peers must draw the same numbers from a seed.
+class SplitMix64 final {
+ public:
+  using result_type = uint64_t;
+
+  explicit SplitMix64(uint64_t seed = 0) : state_(seed) {}
+
+  static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  // The output function of the generator, also used on its own to derive hash keys
+  static constexpr uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+
+    return z ^ (z >> 31);
+  }
+
+  result_type operator()() { return Mix(state_ += kGoldenGamma); }
+
+  // A value in [0, bound)
+  uint32_t Next(uint32_t bound) { return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32); }
+
+  void seed(uint64_t seed) { state_ = seed; }
+
+  uint64_t state() const { return state_; }
+
+ private:
+  static constexpr uint64_t kGoldenGamma = 0x9E3779B97F4A7C15;
+
+  uint64_t state_;
+};
+
+} // namespace utility
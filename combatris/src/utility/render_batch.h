@@ -0,0 +1,117 @@
+#pragma once
+
+#include <SDL.h>
+#include <algorithm>
+#include <vector>
+
+namespace utility {
+
+// Collects textured quads from a single atlas and draws them with one SDL_RenderGeometry call. Renderers
+// older than SDL 2.0.18 fall back to one SDL_RenderCopy per quad, still without switching texture.
+class RenderBatch final {
+ public:
+  explicit RenderBatch(size_t capacity) {
+    quads_.reserve(capacity);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    vertices_.reserve(capacity * 4);
+    indices_.reserve(capacity * 6);
+#endif
+  }
+
+  RenderBatch(const RenderBatch&) = delete;
+
+  inline void Clear() { quads_.clear(); }
+
+  inline size_t size() const { return quads_.size(); }
+
+  // Used by test suit
+  inline const SDL_Rect& dest_rc(size_t i) const { return quads_.at(i).dest_rc_; }
+
+  // Used by test suit
+  inline const SDL_Rect& src_rc(size_t i) const { return quads_.at(i).src_rc_; }
+
+  void Add(const SDL_Rect& dest_rc, const SDL_Rect& src_rc, SDL_Color color = kWhite) {
+    quads_.push_back(Quad { dest_rc, src_rc, color });
+  }
+
+  // Only adds the part of the quad that is inside clip_rc, a batch can not change clip rect half way through
+  void Add(const SDL_Rect& dest_rc, const SDL_Rect& src_rc, const SDL_Rect& clip_rc, SDL_Color color = kWhite) {
+    SDL_Rect rc;
+
+    if (!SDL_IntersectRect(&dest_rc, &clip_rc, &rc)) {
+      return;
+    }
+    const SDL_Rect src {
+      src_rc.x + ((rc.x - dest_rc.x) * src_rc.w) / dest_rc.w,
+      src_rc.y + ((rc.y - dest_rc.y) * src_rc.h) / dest_rc.h,
+      (rc.w * src_rc.w) / dest_rc.w,
+      (rc.h * src_rc.h) / dest_rc.h
+    };
+    quads_.push_back(Quad { rc, src, color });
+  }
+
+  // Returns the number of draw calls issued
+  int Render(SDL_Renderer* renderer, SDL_Texture* atlas) {
+    if (quads_.empty()) {
+      return 0;
+    }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    int w = 0, h = 0;
+
+    SDL_QueryTexture(atlas, nullptr, nullptr, &w, &h);
+
+    const auto u = 1.0f / static_cast<float>(std::max(w, 1));
+    const auto v = 1.0f / static_cast<float>(std::max(h, 1));
+
+    vertices_.clear();
+    indices_.clear();
+    for (const auto& quad : quads_) {
+      const auto& d = quad.dest_rc_;
+      const auto& s = quad.src_rc_;
+      const auto first = static_cast<int>(vertices_.size());
+
+      for (int corner = 0; corner < 4; ++corner) {
+        const auto dx = corner & 1;
+        const auto dy = corner >> 1;
+
+        vertices_.push_back(SDL_Vertex {
+          SDL_FPoint { static_cast<float>(d.x + dx * d.w), static_cast<float>(d.y + dy * d.h) },
+          quad.color_,
+          SDL_FPoint { static_cast<float>(s.x + dx * s.w) * u, static_cast<float>(s.y + dy * s.h) * v } });
+      }
+      for (auto i : { 0, 1, 2, 2, 1, 3 }) {
+        indices_.push_back(first + i);
+      }
+    }
+    SDL_RenderGeometry(renderer, atlas, vertices_.data(), static_cast<int>(vertices_.size()),
+                       indices_.data(), static_cast<int>(indices_.size()));
+
+    return 1;
+#else
+    for (const auto& quad : quads_) {
+      SDL_SetTextureColorMod(atlas, quad.color_.r, quad.color_.g, quad.color_.b);
+      SDL_RenderCopy(renderer, atlas, &quad.src_rc_, &quad.dest_rc_);
+    }
+    SDL_SetTextureColorMod(atlas, kWhite.r, kWhite.g, kWhite.b);
+
+    return static_cast<int>(quads_.size());
+#endif
+  }
+
+ private:
+  static constexpr SDL_Color kWhite { 255, 255, 255, 255 };
+
+  struct Quad {
+    SDL_Rect dest_rc_;
+    SDL_Rect src_rc_;
+    SDL_Color color_;
+  };
+
+  std::vector<Quad> quads_;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int> indices_;
+#endif
+};
+
+} // namespace utility
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Double ended queue in one preallocated block, only allocates if it has to grow beyond its capacity
+template<typename T>
+class RingBuffer {
+ public:
+  explicit RingBuffer(size_t capacity) : items_(RoundUp(capacity)) {}
+
+  void push_back(const T& value) {
+    Grow();
+    items_[(head_ + size_) & mask()] = value;
+    ++size_;
+  }
+
+  void push_front(const T& value) {
+    Grow();
+    head_ = (head_ - 1) & mask();
+    items_[head_] = value;
+    ++size_;
+  }
+
+  inline T& front() {
+    assert(size_ > 0);
+    return items_[head_];
+  }
+
+  void pop_front() {
+    assert(size_ > 0);
+    head_ = (head_ + 1) & mask();
+    --size_;
+  }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  inline size_t size() const { return size_; }
+
+  inline bool empty() const { return 0 == size_; }
+
+  inline size_t capacity() const { return items_.size(); }
+
+ private:
+  static size_t RoundUp(size_t capacity) {
+    size_t n = 1;
+
+    while (n < capacity) {
+      n <<= 1;
+    }
+    return n;
+  }
+
+  inline size_t mask() const { return items_.size() - 1; }
+
+  void Grow() {
+    if (size_ < items_.size()) {
+      return;
+    }
+    std::vector<T> items(items_.size() * 2);
+
+    for (size_t i = 0; i < size_; ++i) {
+      items[i] = items_[(head_ + i) & mask()];
+    }
+    items_.swap(items);
+    head_ = 0;
+  }
+
+  std::vector<T> items_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
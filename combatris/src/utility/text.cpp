@@ -5,6 +5,10 @@ namespace utility {
 std::tuple<UniqueTexturePtr, int, int> CreateTextureFromText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text,
                                                          Color text_color) {
   SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), GetColor(text_color, 0));
+
+  if (nullptr == surface) {
+    return std::make_tuple(UniqueTexturePtr{}, 0, 0);
+  }
   auto texture = UniqueTexturePtr{ SDL_CreateTextureFromSurface(renderer, surface) };
 
   auto width = surface->w;
@@ -27,6 +31,10 @@ std::tuple<UniqueTexturePtr, int, int> CreateTextureFromFramedText(SDL_Renderer*
                                                                const std::string& text, Color text_color,
                                                                Color background_color) {
   SDL_Surface* surface = TTF_RenderText_Shaded(font, text.c_str(), GetColor(text_color), GetColor(background_color));
+
+  if (nullptr == surface) {
+    return std::make_tuple(UniqueTexturePtr{}, 0, 0);
+  }
   auto source_texture = UniqueTexturePtr{ SDL_CreateTextureFromSurface(renderer, surface) };
 
   auto width = surface->w + 2;
@@ -14,6 +14,11 @@ inline int64_t time_in_ms() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(current_time.time_since_epoch()).count();
 }
 
+// Monotonic, for measuring latency
+inline int64_t time_in_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 std::string FormatTimeMMSSHS(size_t t);
 
 class TimerInterface {
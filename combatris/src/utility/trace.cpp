@@ -0,0 +1,164 @@
+#include "utility/trace.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+
+#if defined(_WIN64)
+
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace {
+
+inline int OpenFile(const char* file_name, int flags) {
+  return _open(file_name, flags | _O_WRONLY | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+inline int WriteFile(int fd, const char* data, size_t size) { return _write(fd, data, static_cast<unsigned>(size)); }
+
+inline bool Rewind(int fd) { return 0 == _lseek(fd, 0, SEEK_SET); }
+
+inline bool Truncate(int fd) { return 0 == _chsize(fd, 0); }
+
+inline bool CloseFile(int fd) { return 0 == _close(fd); }
+
+const int kTruncate = _O_TRUNC;
+
+} // namespace
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+inline int OpenFile(const char* file_name, int flags) { return open(file_name, flags | O_WRONLY | O_CREAT, 0644); }
+
+inline ssize_t WriteFile(int fd, const char* data, size_t size) { return write(fd, data, size); }
+
+inline bool Rewind(int fd) { return 0 == lseek(fd, 0, SEEK_SET); }
+
+inline bool Truncate(int fd) { return 0 == ftruncate(fd, 0); }
+
+inline bool CloseFile(int fd) { return 0 == close(fd); }
+
+const int kTruncate = O_TRUNC;
+
+} // namespace
+
+#endif
+
+namespace utility {
+
+namespace {
+
+struct TraceHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t record_size_;
+  uint64_t count_;
+};
+
+// Records are written this many at a time
+const size_t kWriteBatch = 128;
+
+int crash_fd = -1;
+
+bool WriteAll(int fd, const void* data, size_t size) {
+  auto bytes = static_cast<const char*>(data);
+
+  while (size > 0) {
+    const auto written = WriteFile(fd, bytes, size);
+
+    if (written <= 0) {
+      return false;
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+void OnCrash(int signal) {
+  if (Truncate(crash_fd) && Rewind(crash_fd)) {
+    Trace::Write(crash_fd);
+  }
+  std::signal(signal, SIG_DFL);
+  std::raise(signal);
+}
+
+} // namespace
+
+bool Trace::Read(uint64_t index, TraceRecord& record) {
+  const auto& slot = slots_[index & (kCapacity - 1)];
+  const auto stamp = slot.stamp_.load(std::memory_order_acquire);
+
+  if (stamp != index + 1) {
+    return false;
+  }
+  Slot::Words words;
+
+  for (size_t i = 0; i < words.size(); ++i) {
+    words[i] = slot.words_[i].load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.stamp_.load(std::memory_order_relaxed) != stamp) {
+    return false;
+  }
+  std::memcpy(&record, words.data(), sizeof(record));
+
+  return true;
+}
+
+bool Trace::Write(int fd) {
+  const auto index = index_.load(std::memory_order_acquire);
+  TraceHeader header { {}, 1, sizeof(TraceRecord), 0 };
+  std::array<TraceRecord, kWriteBatch> records;
+  size_t n = 0;
+
+  std::copy(std::begin(kMagic), std::end(kMagic), header.magic_);
+  auto ok = WriteAll(fd, &header, sizeof(header));
+  for (auto i = index - std::min<uint64_t>(index, kCapacity); ok && i < index; ++i) {
+    if (!Read(i, records[n])) {
+      continue;
+    }
+    ++header.count_;
+    if (++n == records.size()) {
+      ok = WriteAll(fd, records.data(), n * sizeof(TraceRecord));
+      n = 0;
+    }
+  }
+  ok = ok && WriteAll(fd, records.data(), n * sizeof(TraceRecord));
+  // The count is only known once the records that could be read are written
+  return ok && Rewind(fd) && WriteAll(fd, &header, sizeof(header));
+}
+
+bool Trace::Dump(const std::string& file_name) {
+  const auto fd = OpenFile(file_name.c_str(), kTruncate);
+
+  if (fd < 0) {
+    return false;
+  }
+  const auto ok = Write(fd);
+
+  return CloseFile(fd) && ok;
+}
+
+void Trace::DumpOnCrash(const std::string& file_name) {
+  if (crash_fd >= 0) {
+    CloseFile(crash_fd);
+  }
+  // Not truncated until there is a crash, the last dump is kept until then
+  crash_fd = OpenFile(file_name.c_str(), 0);
+  if (crash_fd < 0) {
+    return;
+  }
+  for (auto signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL }) {
+    std::signal(signal, OnCrash);
+  }
+}
+
+} // namespace utility
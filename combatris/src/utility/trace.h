@@ -0,0 +1,81 @@
+#pragma once
+
+#include "utility/timer.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace utility {
+
+enum class TraceKind : uint8_t { None, EventPush, EventSchedule, EventPop, SpriteState, NetworkSend, NetworkReceive };
+
+struct TraceRecord {
+  int64_t timestamp_; // nanoseconds, monotonic clock
+  TraceKind kind_;
+  uint8_t code_; // event type, sprite state or network request
+  uint16_t reserved_;
+  int32_t value1_;
+  uint64_t value2_;
+};
+
+static_assert(sizeof(TraceRecord) == 24);
+
+// Always on binary trace of the last kCapacity records, any thread can record. A dump is a header followed
+// by the records oldest first, tools/decode_trace.py turns it into a timeline.
+//
+// Every slot is stamped with the index of the record it holds once the record is written, a dump leaves out
+// the slots that are being written or have been overwritten while they were read. A writer that wraps around
+// onto a slot still being written waits for it.
+class Trace final {
+ public:
+  static constexpr size_t kCapacity = size_t(1) << 16;
+  static constexpr char kMagic[8] = { 'C', 'B', 'T', 'R', 'A', 'C', 'E', '1' };
+
+  static void Record(TraceKind kind, uint8_t code, int32_t value1 = 0, uint64_t value2 = 0) {
+    const auto index = index_.fetch_add(1, std::memory_order_relaxed);
+    const TraceRecord record { time_in_ns(), kind, code, 0, value1, value2 };
+    auto& slot = slots_[index & (kCapacity - 1)];
+    Slot::Words words;
+
+    std::memcpy(words.data(), &record, sizeof(record));
+    for (auto stamp = slot.stamp_.load(std::memory_order_relaxed);
+         kWriting == stamp || !slot.stamp_.compare_exchange_weak(stamp, kWriting, std::memory_order_relaxed);) {
+      stamp = slot.stamp_.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < words.size(); ++i) {
+      slot.words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.stamp_.store(index + 1, std::memory_order_release);
+  }
+
+  static bool Dump(const std::string& file_name);
+
+  // Writes the dump to an open file, async signal safe
+  static bool Write(int fd);
+
+  // Opens file_name up front and dumps the trace to it if the process crashes, the signal handler only
+  // makes system calls so a corrupt heap can not hang it
+  static void DumpOnCrash(const std::string& file_name);
+
+ private:
+  static constexpr uint64_t kWriting = ~uint64_t(0);
+
+  struct Slot {
+    using Words = std::array<uint64_t, sizeof(TraceRecord) / sizeof(uint64_t)>;
+
+    std::atomic<uint64_t> stamp_; // index + 1 of the record in the slot, 0 if empty and kWriting while it is written
+    std::array<std::atomic<uint64_t>, std::tuple_size_v<Words>> words_;
+  };
+
+  // The record with the given index, false if the slot does not hold it
+  static bool Read(uint64_t index, TraceRecord& record);
+
+  inline static std::array<Slot, kCapacity> slots_ = {};
+  inline static std::atomic<uint64_t> index_ = 0;
+};
+
+} // namespace utility
@@ -1,8 +1,16 @@
 #include "test_utility.h"
 #include "game/tetromino_sprite.h"
+#include "game/tetromino_generator.h"
+#include "game/campaign.h"
+#include "game/coop_matrix.h"
+#include "game/rotation_system.h"
+#include "game/randomizer.h"
+#include "utility/auto_repeat.h"
 
 #include "catch.hpp"
 
+#include <cstring>
+
 const std::vector<std::vector<int>> kSendLinesBefore {
   {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 01
   {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 02
@@ -43,6 +51,50 @@ TEST_CASE("SendLines") {
   REQUIRE(*matrix == kSendLinesBefore);
 }
 
+TEST_CASE("SendLinesSameSeed") {
+  auto matrix1 = SetupTestHarnessMatrixOnly(kSendLinesBefore);
+  auto matrix2 = SetupTestHarnessMatrixOnly(kSendLinesBefore);
+
+  matrix1->Update(Event(Event::Type::MultiPlayerSetSeed, size_t(4711)));
+  matrix2->Update(Event(Event::Type::MultiPlayerSetSeed, size_t(4711)));
+  for (int lines = 1; lines <= 4; ++lines) {
+    matrix1->InsertSolidLines(lines);
+    matrix2->InsertSolidLines(lines);
+  }
+  const auto random = matrix1->garbage_random();
+
+  matrix1->InsertSolidLines(4);
+  matrix2->SetGarbageRandom(random);
+  matrix2->InsertSolidLines(4);
+  for (int row = kMatrixFirstRow; row < kMatrixLastRow; ++row) {
+    for (int col = kMatrixFirstCol; col < kMatrixLastCol; ++col) {
+      REQUIRE(matrix1->at(row, col) == matrix2->at(row, col));
+    }
+  }
+}
+
+TEST_CASE("SendLinesSnapshot") {
+  auto matrix = SetupTestHarnessMatrixOnly(kSendLinesBefore);
+  GameStateSnapshot before;
+  GameStateSnapshot after;
+
+  matrix->InsertSolidLines(3);
+  matrix->Capture(before);
+  matrix->InsertSolidLines(4);
+  matrix->Capture(after);
+  matrix->Commit(Tetromino::Type::I, Tetromino::Angle::A0, Tetromino::Move::Down, Position(kSkylineStartRow, kMatrixFirstCol));
+  matrix->Restore(before);
+  REQUIRE(matrix->filled_cells() == 12 + 3 * (kVisibleCols - 1));
+  matrix->InsertSolidLines(4);
+
+  GameStateSnapshot replayed;
+
+  matrix->Capture(replayed);
+  REQUIRE(std::memcmp(&after, &replayed, sizeof(GameStateSnapshot::MatrixState)) == 0);
+  matrix->RemoveSolidLines();
+  REQUIRE(*matrix == kSendLinesBefore);
+}
+
 const std::vector<std::vector<int>> kTopOutGameover {
   {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 01
   {1, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 02
@@ -230,3 +282,739 @@ TEST_CASE("IsAboveSkylineTest") {
 
   REQUIRE(!matrix->IsAboveSkyline(kSpawnPosition, rotation_data));
 }
+
+const std::vector<std::vector<int>> kDropPosition {
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 01
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 02
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 03
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 04
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 05
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 06
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 07
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 08
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 09
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 10
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 11
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 12
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 13
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 14
+  {1, 1, 1, 0, 0, 0, 0, 0, 0, 0}, // 15
+  {0, 0, 1, 0, 0, 0, 0, 0, 0, 0}, // 16
+  {0, 0, 0, 0, 0, 0, 1, 1, 0, 0}, // 17
+  {0, 0, 0, 0, 0, 1, 1, 0, 0, 1}, // 18
+  {0, 0, 0, 1, 1, 1, 1, 0, 1, 1}, // 19
+  {1, 1, 0, 1, 1, 1, 1, 0, 1, 1}  // 20
+};
+
+TEST_CASE("DropPositionTest") {
+  auto [assets, matrix] = SetupTestHarness(kDropPosition);
+  auto tetrominos = assets->GetTetrominos();
+
+  auto probe_drop_position = [&matrix](Position pos, const TetrominoRotationData& rotation_data) {
+    while (matrix->IsValid(Position(pos.row() + 1, pos.col()), rotation_data)) {
+      pos.inc_row();
+    }
+    return pos;
+  };
+
+  REQUIRE(matrix->column_top(kMatrixFirstCol) == kMatrixFirstRow + 14);
+  REQUIRE(matrix->first_hole(kMatrixFirstCol) == kMatrixFirstRow + 15);
+  REQUIRE(matrix->column_top(kMatrixFirstCol + 3) == kMatrixFirstRow + 18);
+  REQUIRE(matrix->first_hole(kMatrixFirstCol + 3) == kMatrixLastRow);
+
+  for (int i = 0; i < 2; ++i) {
+    for (const auto& tetromino : tetrominos) {
+      if (tetromino->type() > Tetromino::Type::Z) {
+        continue;
+      }
+      for (int angle = 0; angle < 4; ++angle) {
+        const auto& rotation_data = tetromino->GetRotationData(static_cast<Tetromino::Angle>(angle));
+
+        for (int row = kSkylineStartRow; row < kMatrixLastRow; ++row) {
+          for (int col = 0; col < kMatrixLastCol; ++col) {
+            const Position pos(row, col);
+
+            if (matrix->IsValid(pos, rotation_data)) {
+              REQUIRE(matrix->GetDropPosition(pos, rotation_data) == probe_drop_position(pos, rotation_data));
+            }
+          }
+        }
+      }
+    }
+    // Tuck an I under the overhang to the left and drop a T on the right, the columns must follow
+    matrix->Commit(Tetromino::Type::I, Tetromino::Angle::A90, Tetromino::Move::Down, Position(kMatrixFirstRow + 15, kMatrixFirstCol - 2 + i));
+    matrix->Commit(Tetromino::Type::T, Tetromino::Angle::A0, Tetromino::Move::Down, Position(kSkylineStartRow, kMatrixFirstCol + 6));
+  }
+}
+
+TEST_CASE("DropPositionOverlayTest") {
+  auto [assets, matrix] = SetupTestHarness(kDropPosition);
+  auto tetrominos = assets->GetTetrominos();
+  const auto& rotation_data = tetrominos[static_cast<int>(Tetromino::Type::O) - 1]->GetRotationData(Tetromino::Angle::A0);
+  const auto id = static_cast<int>(Tetromino::Type::O);
+  const Position pos(kSkylineStartRow, kMatrixFirstCol + 2);
+
+  matrix->Insert(pos, rotation_data);
+
+  REQUIRE(*matrix == kDropPosition);
+  REQUIRE(matrix->at(pos.row(), pos.col() + 1) == id);
+  REQUIRE(matrix->at(pos.row() + 1, pos.col() + 2) == id);
+  REQUIRE(matrix->at(kMatrixFirstRow + 16, pos.col() + 1) == id + kGhostAddOn);
+  REQUIRE(matrix->at(kMatrixFirstRow + 17, pos.col() + 2) == id + kGhostAddOn);
+  REQUIRE(matrix->at(kMatrixFirstRow + 18, pos.col() + 2) == static_cast<int>(Tetromino::Type::I));
+
+  matrix->Insert(Position(pos.row(), pos.col() + 1), rotation_data);
+
+  REQUIRE(matrix->at(pos.row(), pos.col() + 1) == kEmptyID);
+  REQUIRE(matrix->at(kMatrixFirstRow + 16, pos.col() + 1) == kEmptyID);
+  REQUIRE(matrix->at(pos.row(), pos.col() + 3) == id);
+}
+
+template <typename BoardType>
+void TestBoardGeometry() {
+  BoardType board;
+  const auto& rotation_data = kTetrominoRotationShape_I_0D;
+
+  REQUIRE(board.IsValid(Position(BoardType::kFirstRow, BoardType::kFirstCol), rotation_data));
+  REQUIRE_FALSE(board.IsValid(Position(BoardType::kFirstRow, BoardType::kLastCol - 3), rotation_data));
+
+  for (int col = BoardType::kFirstCol; col < BoardType::kLastCol; col += 4) {
+    board.Insert(Position(BoardType::kLastRow - 2, col), rotation_data);
+  }
+  REQUIRE(board.Scan().full_ == uint64_t(1) << (BoardType::kLastRow - 1));
+  REQUIRE(board.MoveLinesUp(1) == 1);
+  board.InsertSolidLine(BoardType::kLastRow - 1, BoardType::kFirstCol);
+  REQUIRE(board.Scan().solid_ == uint64_t(1) << (BoardType::kLastRow - 1));
+  REQUIRE(board.IsFull(BoardType::kLastRow - 2));
+}
+
+TEST_CASE("BoardGeometries", "[matrix]") {
+  TestBoardGeometry<BasicBoard<20, 4, 20>>();
+  TestBoardGeometry<BasicBoard<40, 20, 20>>();
+  TestBoardGeometry<BasicBoard<40, 40, 20>>();
+  TestBoardGeometry<BasicBoard<20, 60, 20>>();
+}
+
+TEST_CASE("BoardCoop", "[matrix]") {
+  using CoopBoard = BasicBoard<20, 40, 20>;
+
+  CoopMatrix<CoopBoard> matrix;
+  const auto& rotation_data = kTetrominoRotationShape_I_0D;
+  std::vector<int> pieces;
+
+  for (int i = 0; i < 8; ++i) {
+    pieces.push_back(matrix.Spawn(Position(CoopBoard::kFirstRow, CoopBoard::kFirstCol + i * 4), rotation_data));
+    REQUIRE(pieces.back() == i);
+  }
+  REQUIRE(matrix.Spawn(Position(CoopBoard::kFirstRow, CoopBoard::kFirstCol), rotation_data) == CoopMatrix<CoopBoard>::kNoPiece);
+  REQUIRE(matrix.at(CoopBoard::kFirstRow + 1, CoopBoard::kFirstCol + 5) == static_cast<int>(Tetromino::Type::I));
+  REQUIRE_FALSE(matrix.Move(pieces[7], Position(CoopBoard::kFirstRow, CoopBoard::kLastCol - 3), rotation_data));
+
+  for (auto piece : pieces) {
+    REQUIRE(matrix.Commit(piece) == 0);
+  }
+  for (int i = 0; i < 2; ++i) {
+    const auto piece = matrix.Spawn(Position(CoopBoard::kFirstRow, CoopBoard::kFirstCol + 32 + i * 4), rotation_data);
+
+    REQUIRE(matrix.GetDropPosition(piece).row() == CoopBoard::kLastRow - 2);
+    REQUIRE(matrix.Commit(piece) == ((i == 0) ? 0 : uint64_t(1) << (CoopBoard::kLastRow - 1)));
+  }
+  REQUIRE(matrix.board().Scan().empty_ == (uint64_t(1) << CoopBoard::kLastRow) - 1);
+}
+
+TEST_CASE("BoardOccupancy", "[matrix]") {
+  Board board;
+  const auto& rotation_data = kTetrominoRotationShape_I_0D;
+
+  REQUIRE(board.total_filled() == 0);
+  REQUIRE(board.highest_row() == Board::kLastRow);
+
+  for (int i = 0; i < 2; ++i) {
+    board.Insert(Position(Board::kLastRow - 2, Board::kFirstCol + i * 4), rotation_data);
+  }
+  REQUIRE(board.filled(Board::kLastRow - 1) == 8);
+  REQUIRE(board.total_filled() == 8);
+  REQUIRE(board.highest_row() == Board::kLastRow - 1);
+
+  REQUIRE(board.MoveLinesUp(2) == 2);
+  board.InsertSolidLine(Board::kLastRow - 2, Board::kFirstCol);
+  board.InsertSolidLine(Board::kLastRow - 1, Board::kFirstCol + 1);
+  REQUIRE(board.filled(Board::kLastRow - 3) == 8);
+  REQUIRE(board.filled(Board::kLastRow - 1) == kVisibleCols - 1);
+  REQUIRE(board.total_filled() == 8 + 2 * (kVisibleCols - 1));
+  REQUIRE(board.highest_row() == Board::kLastRow - 3);
+
+  board.MoveLineDown(Board::kLastRow - 3);
+  REQUIRE(board.total_filled() == 2 * (kVisibleCols - 1));
+  REQUIRE(board.highest_row() == Board::kLastRow - 2);
+
+  board.MoveLineDown(Board::kLastRow - 1);
+  board.MoveLineDown(Board::kLastRow - 1);
+  REQUIRE(board.total_filled() == 0);
+  REQUIRE(board.highest_row() == Board::kLastRow);
+}
+
+TEST_CASE("BoardHash", "[matrix]") {
+  auto matrix = SetupTestHarnessMatrixOnly(kSendLinesBefore);
+  const auto& rotation_data = kTetrominoRotationShape_T_0D;
+  const auto initial_hash = SetupTestHarnessMatrixOnly(kSendLinesBefore)->hash();
+
+  REQUIRE(matrix->hash() == matrix->ComputeHash());
+  matrix->Insert(Position(kSkylineStartRow, kMatrixFirstCol), rotation_data);
+  REQUIRE(matrix->hash() != initial_hash);
+  REQUIRE(matrix->hash() == matrix->ComputeHash());
+
+  for (int i = 0; i < 40; ++i) {
+    const auto col = kMatrixFirstCol + (i * 3) % (kVisibleCols - 2);
+
+    matrix->Commit(Tetromino::Type::T, Tetromino::Angle::A0, Tetromino::Move::Down, Position(kSkylineStartRow, col));
+    REQUIRE(matrix->hash() == matrix->ComputeHash());
+    if (i % 5 == 0) {
+      matrix->InsertSolidLines(2);
+      REQUIRE(matrix->hash() == matrix->ComputeHash());
+    }
+    if (matrix->highest_row() < kMatrixFirstRow + 4) {
+      matrix->RemoveSolidLines();
+      REQUIRE(matrix->hash() == matrix->ComputeHash());
+    }
+  }
+  matrix->SetTestData(kSendLinesBefore);
+  REQUIRE(matrix->hash() == initial_hash);
+}
+
+TEST_CASE("RotationSystems", "[game]") {
+  using Angle = Tetromino::Angle;
+
+  REQUIRE(RotationState(Angle::A0, true) == 0);
+  REQUIRE(RotationState(Angle::A90, false) == 1);
+  REQUIRE(RotationState(Angle::A90, true) == 2);
+  REQUIRE(RotationState(Angle::A180, false) == 3);
+  REQUIRE(RotationState(Angle::A180, true) == 4);
+  REQUIRE(RotationState(Angle::A270, false) == 5);
+  REQUIRE(RotationState(Angle::A270, true) == 6);
+  REQUIRE(RotationState(Angle::A0, false) == 7);
+
+  // A rotation and its mirror image kick to mirrored columns
+  const std::vector<std::pair<int, int>> kMirrors = { {0, 7}, {1, 6}, {2, 5}, {3, 4} };
+
+  for (const auto& [state, mirror] : kMirrors) {
+    for (size_t i = 0; i < SRSPlus::kI[state].size(); ++i) {
+      REQUIRE(SRSPlus::kI[state][i].col_ == -SRSPlus::kI[mirror][i].col_);
+      REQUIRE(SRSPlus::kI[state][i].row_ == SRSPlus::kI[mirror][i].row_);
+    }
+  }
+  REQUIRE(ARS::kI[0].size() == 1);
+}
+
+TEST_CASE("RotationSystemKicks", "[game]") {
+  using Angle = Tetromino::Angle;
+  using Result = std::tuple<Position, Angle, int>;
+
+  SpriteTestHarness harness(kSendLinesBefore);
+  // Rotates a tetromino at row 30, col 5 clockwise from spawn angle on an empty matrix with the given minos filled
+  auto rotate = [&harness](RotationSystemType rotation_system, Tetromino::Type type, const std::vector<Position>& filled) {
+    Matrix::Type matrix(kVisibleRows, std::vector<int>(kVisibleCols, 0));
+
+    for (const auto& pos : filled) {
+      matrix.at(pos.row() - kMatrixFirstRow).at(pos.col() - kMatrixFirstCol) = 1;
+    }
+    harness.matrix_->SetTestData(matrix);
+
+    TetrominoSprite sprite(harness.tetromino(type), harness.level_, harness.events_, harness.matrix_);
+    GameStateSnapshot snapshot;
+
+    sprite.Reset(harness.tetromino(type), rotation_system);
+    snapshot.sprite_ = { type, Position(30, 5), Angle::A0, Tetromino::Move::None, -1, 0, static_cast<int>(TetrominoSprite::State::Falling), false };
+    sprite.Restore(snapshot);
+    sprite.RotateClockwise();
+    sprite.Capture(snapshot);
+
+    return Result(snapshot.sprite_.pos_, snapshot.sprite_.angle_, snapshot.sprite_.last_kick_);
+  };
+  // The vertical I is blocked in its own column, SRS kicks it two columns left and SRS+ one column right
+  const std::vector<Position> kBlockI = { Position(32, 7) };
+
+  REQUIRE(rotate(RotationSystemType::SRS, Tetromino::Type::I, kBlockI) == Result(Position(30, 3), Angle::A90, 1));
+  REQUIRE(rotate(RotationSystemType::SRSPlus, Tetromino::Type::I, kBlockI) == Result(Position(30, 6), Angle::A90, 1));
+  REQUIRE(rotate(RotationSystemType::ARS, Tetromino::Type::I, kBlockI) == Result(Position(30, 5), Angle::A0, -1));
+  REQUIRE(rotate(RotationSystemType::ARS, Tetromino::Type::I, {}) == Result(Position(30, 5), Angle::A90, 0));
+
+  // The stem of the T is blocked, SRS and SRS+ try left first, ARS tries right first
+  const std::vector<Position> kBlockT = { Position(32, 6) };
+
+  REQUIRE(rotate(RotationSystemType::SRS, Tetromino::Type::T, kBlockT) == Result(Position(30, 4), Angle::A90, 1));
+  REQUIRE(rotate(RotationSystemType::SRSPlus, Tetromino::Type::T, kBlockT) == Result(Position(30, 4), Angle::A90, 1));
+  REQUIRE(rotate(RotationSystemType::ARS, Tetromino::Type::T, kBlockT) == Result(Position(30, 6), Angle::A90, 1));
+  REQUIRE(rotate(RotationSystemType::ARS, Tetromino::Type::T, { Position(32, 6), Position(30, 7) }) == Result(Position(30, 4), Angle::A90, 2));
+  // ARS has no floor kicks
+  REQUIRE(rotate(RotationSystemType::ARS, Tetromino::Type::T, { Position(32, 5), Position(32, 6), Position(32, 7) }) == Result(Position(30, 5), Angle::A0, -1));
+}
+
+TEST_CASE("Randomizers", "[game]") {
+  const uint64_t kSeed = 4711;
+
+  for (int bag = 0; bag < 100; ++bag) {
+    std::array<int, 8> count {};
+
+    for (int i = 0; i < 14; ++i) {
+      count.at(static_cast<int>(GetRandomizer(RandomizerType::FourteenBag).PieceAt(kSeed, bag * 14 + i)))++;
+    }
+    REQUIRE(std::count(count.begin() + 1, count.end(), 2) == 7);
+    count.fill(0);
+    for (int i = 0; i < 7; ++i) {
+      count.at(static_cast<int>(GetRandomizer(RandomizerType::SevenBag).PieceAt(kSeed, bag * 7 + i)))++;
+    }
+    REQUIRE(std::count(count.begin() + 1, count.end(), 1) == 7);
+  }
+  const auto first = GetRandomizer(RandomizerType::History).PieceAt(kSeed, 0);
+
+  REQUIRE(first != Tetromino::Type::S);
+  REQUIRE(first != Tetromino::Type::Z);
+  REQUIRE(first != Tetromino::Type::O);
+
+  // Looking a piece up directly gives the same piece as the stream, and the stream only depends on the seed
+  for (auto type : { RandomizerType::SevenBag, RandomizerType::FourteenBag, RandomizerType::History, RandomizerType::Random }) {
+    const auto& randomizer = GetRandomizer(type);
+    std::vector<Tetromino::Type> stream;
+
+    for (uint64_t n = 0; n < 200; ++n) {
+      stream.push_back(randomizer.PieceAt(kSeed, n));
+      REQUIRE(stream.back() >= Tetromino::Type::I);
+      REQUIRE(stream.back() <= Tetromino::Type::Z);
+    }
+    for (int n = 199; n >= 0; n -= 7) {
+      REQUIRE(randomizer.PieceAt(kSeed, n) == stream.at(n));
+    }
+    REQUIRE(randomizer.PieceAt(kSeed + 1, 1000000) == randomizer.PieceAt(kSeed + 1, 1000000));
+  }
+}
+
+TEST_CASE("GravityFrameRate", "[game]") {
+  auto fall = [](double gravity, int fps, double seconds) {
+    Gravity g;
+    int rows = 0;
+
+    g.Set(gravity);
+    for (int frame = 0; frame < static_cast<int>(seconds * fps); ++frame) {
+      rows += g.Step(1.0 / fps, kMatrixLastRow);
+    }
+    return rows;
+  };
+
+  for (auto gravity : { 0.01667, 0.047, 0.5, 1.0, 2.36 }) {
+    const auto expected = fall(gravity, 60, 2.0);
+
+    for (auto fps : { 30, 120, 144, 240, 1000 }) {
+      REQUIRE(fall(gravity, fps, 2.0) == expected);
+    }
+  }
+  REQUIRE(fall(0.5, 144, 2.0) == 60);
+  REQUIRE(fall(1.0, 32, 4.0) == 240);
+  REQUIRE(fall(1.0, 1024, 4.0) == 240);
+
+  Gravity g;
+
+  g.Set(20.0);
+  REQUIRE(g.Step(1.0 / 1000, kMatrixLastRow) == kMatrixLastRow);
+  REQUIRE(g.Step(0.0, kMatrixLastRow) == kMatrixLastRow);
+  REQUIRE(g.TimeLeft(0, 0.25) == 0.25);
+
+  g.Set(1.0);
+  REQUIRE(g.Step(0.1, kMatrixLastRow) == 6);
+  // 6 rows fell in 0.1 seconds, the last one of them took 1/60 of a second
+  REQUIRE(std::abs(g.TimeLeft(1, 0.1) - 1.0 / 60.0) < 1e-9);
+  REQUIRE(g.TimeLeft(100, 0.1) == 0.1);
+
+  g.Set(0.01667);
+  g.Release();
+  g.Release();
+  REQUIRE(g.Step(0.0, kMatrixLastRow) == 1);
+  g.Add(1.0);
+  g.Add(1.0);
+  REQUIRE(g.Step(0.0, kMatrixLastRow) == 2);
+  REQUIRE(g.Step(0.0, kMatrixLastRow) == 0);
+}
+
+TEST_CASE("SpriteGravityFrameRate", "[game]") {
+  SpriteTestHarness harness(kSendLinesBefore);
+  TetrominoGenerator generator(harness.matrix_, harness.level_, harness.events_, harness.assets_);
+  GameStateSnapshot snapshot;
+  const auto kLockDelay = 0.5;
+
+  harness.level_->Update(Event(Event::Type::SetStartLevel, kMaxNumberOfLevels + 1));
+  for (auto fps : { 30, 60, 144, 1000 }) {
+    const auto time_delta = 1.0 / fps;
+    auto sprite = generator.Get(Tetromino::Type::T);
+
+    harness.level_->ResetTime();
+    REQUIRE(sprite->Generate(false) == TetrominoSprite::State::Generated);
+    // At 20G the tetromino is on the stack the step it spawns
+    REQUIRE(sprite->Down(time_delta) == TetrominoSprite::State::OnFloor);
+    sprite->Capture(snapshot);
+    REQUIRE(snapshot.sprite_.pos_ == harness.matrix_->GetDropPosition(snapshot.sprite_.pos_, harness.tetromino(Tetromino::Type::T).GetRotationData(Tetromino::Angle::A0)));
+    REQUIRE(snapshot.sprite_.pos_.row() == 37);
+
+    // The spawn step counts towards the lock delay, it locks after the same time at any frame rate
+    int steps = 1;
+
+    do {
+      ++steps;
+    } while (sprite->Down(time_delta) == TetrominoSprite::State::OnFloor);
+    REQUIRE(steps == static_cast<int>(std::lround(kLockDelay * fps)));
+  }
+}
+
+TEST_CASE("LevelSnapshot", "[game]") {
+  const double kStep = 0.013;
+
+  SpriteTestHarness harness(kSendLinesBefore);
+  TetrominoGenerator generator(harness.matrix_, harness.level_, harness.events_, harness.assets_);
+  auto sprite = generator.Get(Tetromino::Type::T);
+  auto play = [&sprite, kStep](int steps) {
+    std::vector<std::pair<int, TetrominoSprite::State>> trail;
+    GameStateSnapshot snapshot;
+
+    for (int step = 0; step < steps; ++step) {
+      const auto state = sprite->Down(kStep);
+
+      sprite->Capture(snapshot);
+      trail.emplace_back(snapshot.sprite_.pos_.row(), state);
+    }
+    return trail;
+  };
+
+  harness.level_->Update(Event(Event::Type::SetStartLevel, 10));
+  sprite->Generate(false);
+  // Part way through a row, falling and in the lock delay
+  for (auto steps : { 7, 50, 40 }) {
+    GameStateSnapshot snapshot;
+
+    play(steps);
+    harness.matrix_->Capture(snapshot);
+    sprite->Capture(snapshot);
+    harness.level_->Capture(snapshot);
+
+    const auto trail = play(100);
+
+    harness.matrix_->Restore(snapshot);
+    sprite->Restore(snapshot);
+    harness.level_->Restore(snapshot);
+    REQUIRE(play(100) == trail);
+    harness.matrix_->Restore(snapshot);
+    sprite->Restore(snapshot);
+    harness.level_->Restore(snapshot);
+  }
+}
+
+TEST_CASE("MasterLevels", "[game]") {
+  SpriteTestHarness harness(kSendLinesBefore);
+  auto& level = *harness.level_;
+  auto play = [&harness, &level](CampaignType campaign, int start_level, int level_ups) {
+    harness.events_.Clear();
+    level.Update(Event(Event::Type::SetCampaign, campaign));
+    level.Update(Event(Event::Type::SetStartLevel, start_level));
+    level.Reset();
+    for (int i = 0; i < level_ups; ++i) {
+      level.Update(Event(Event::Type::LinesCleared, 100));
+    }
+    return level.level();
+  };
+
+  REQUIRE(play(CampaignType::Combatris, 14, 5) == kMaxNumberOfLevels);
+  REQUIRE(play(CampaignType::Royal, 1, 30) == kMaxNumberOfLevels);
+  REQUIRE(play(CampaignType::Combatris, kMaxNumberOfLevels + 1, 10) == kMaxNumberOfLevels + kNumberOfMasterLevels);
+  play(CampaignType::Marathon, kMaxNumberOfLevels, 1);
+  REQUIRE(harness.events_.IsQueued(Event::Type::GameOver));
+  REQUIRE(play(CampaignType::Marathon, kMaxNumberOfLevels + 1, 4) == kMaxNumberOfLevels + kNumberOfMasterLevels);
+  REQUIRE(!harness.events_.IsQueued(Event::Type::GameOver));
+  play(CampaignType::Marathon, kMaxNumberOfLevels + 1, 5);
+  REQUIRE(harness.events_.IsQueued(Event::Type::GameOver));
+}
+
+TEST_CASE("SpriteReleaseAfterHardDrop", "[game]") {
+  SpriteTestHarness harness(kSendLinesBefore);
+  TetrominoGenerator generator(harness.matrix_, harness.level_, harness.events_, harness.assets_);
+  GameStateSnapshot snapshot;
+  auto row = [&snapshot](const TetrominoSprite& sprite) {
+    sprite.Capture(snapshot);
+    return snapshot.sprite_.pos_.row();
+  };
+
+  for (auto hold : { false, true }) {
+    auto sprite = generator.Get(Tetromino::Type::T);
+
+    REQUIRE(sprite->Generate(false) == TetrominoSprite::State::Generated);
+    sprite->HardDrop();
+    REQUIRE(sprite->Down(0.0) == TetrominoSprite::State::Commited);
+    sprite = generator.Get(Tetromino::Type::J);
+    sprite->Generate(false);
+    if (hold) {
+      // Held the frame it spawned, the next tetromino falls from the spawn position
+      sprite = generator.Get(Tetromino::Type::L);
+      sprite->Generate(false);
+    }
+    const auto spawn_row = row(*sprite);
+
+    sprite->Down(0.0);
+    REQUIRE(row(*sprite) == spawn_row + 1);
+    sprite->Down(0.0);
+    REQUIRE(row(*sprite) == spawn_row + 1);
+    sprite->SoftDrop();
+    sprite->SoftDrop();
+    sprite->Down(0.0);
+    REQUIRE(row(*sprite) == spawn_row + 3);
+    sprite->HardDrop();
+    REQUIRE(sprite->Down(0.0) == TetrominoSprite::State::Commited);
+  }
+}
+
+TEST_CASE("TetrominoGeneratorPool", "[game]") {
+  SpriteTestHarness harness(kSendLinesBefore);
+  TetrominoGenerator generator(harness.matrix_, harness.level_, harness.events_, harness.assets_);
+  const auto pool_size = generator.pool_size();
+  std::shared_ptr<TetrominoSprite> in_play;
+  GameStateSnapshot snapshot;
+
+  harness.matrix_->Capture(snapshot);
+  // Spawning over the tetromino in play, and holding it, as Tetrion does
+  for (int i = 0; i < 100; ++i) {
+    in_play = generator.Get();
+    in_play->Generate(false);
+    if (i % 3 == 0) {
+      generator.Put(in_play->tetromino().type());
+      in_play.reset();
+    } else {
+      in_play->HardDrop();
+      in_play->Down(0.0);
+    }
+    harness.matrix_->Restore(snapshot);
+  }
+  REQUIRE(generator.pool_size() == pool_size);
+
+  // An on floor animation still holds the previous tetromino when the one in play is replaced
+  auto on_floor = generator.Get(Tetromino::Type::T);
+
+  in_play = generator.Get(Tetromino::Type::S);
+
+  auto next = generator.Get(Tetromino::Type::Z);
+
+  REQUIRE(generator.pool_size() == pool_size + 1);
+  REQUIRE(next != on_floor);
+  REQUIRE(next != in_play);
+  on_floor.reset();
+  in_play = generator.Get(Tetromino::Type::O);
+  REQUIRE(generator.pool_size() == pool_size + 1);
+
+  // A reused sprite starts over at the spawn position
+  const auto* sprite = next.get();
+
+  on_floor = generator.Get(Tetromino::Type::I);
+  next->Generate(true);
+  next->RotateClockwise();
+  next->Left();
+  next->Down(0.5);
+  next->HardDrop();
+  next.reset();
+  next = generator.Get(Tetromino::Type::L);
+  REQUIRE(generator.pool_size() == pool_size + 1);
+  REQUIRE(next.get() == sprite);
+  REQUIRE(next->state() == TetrominoSprite::State::Generated);
+  next->Capture(snapshot);
+  REQUIRE(snapshot.sprite_.type_ == Tetromino::Type::L);
+  REQUIRE(snapshot.sprite_.pos_ == kSpawnPosition);
+  REQUIRE(snapshot.sprite_.angle_ == kSpawnAngle);
+  REQUIRE(snapshot.sprite_.last_move_ == Tetromino::Move::None);
+  REQUIRE(snapshot.sprite_.last_kick_ == -1);
+  REQUIRE(snapshot.sprite_.reset_delay_counter_ == 0);
+  REQUIRE(!snapshot.sprite_.got_lines_);
+}
+
+TEST_CASE("CampaignSubscriptions", "[game]") {
+  SpriteTestHarness harness(kSendLinesBefore);
+  Campaign campaign(nullptr, nullptr, harness.events_, harness.assets_, harness.matrix_);
+  auto hold_queue = campaign.GetHoldQueuePane();
+  GameStateSnapshot snapshot;
+
+  hold_queue->Capture(snapshot);
+  snapshot.hold_queue_.can_hold_ = false;
+  hold_queue->Restore(snapshot);
+  // The hold queue only subscribes to CanHold
+  for (size_t type = 0; type < Event::kNumberOfTypes; ++type) {
+    if (Event::Type::CanHold != static_cast<Event::Type>(type)) {
+      campaign.PreprocessEvent(Event(static_cast<Event::Type>(type)));
+    }
+  }
+  REQUIRE_FALSE(hold_queue->CanHold());
+  campaign.PreprocessEvent(Event(Event::Type::CanHold));
+  REQUIRE(hold_queue->CanHold());
+
+  for (size_t type = 0; type < Event::kNumberOfTypes; ++type) {
+    const auto& subscribers = campaign.subscribers(static_cast<Event::Type>(type));
+
+    for (const auto* listener : campaign.event_listeners()) {
+      const auto in_table = std::find(subscribers.begin(), subscribers.end(), listener) != subscribers.end();
+
+      REQUIRE(in_table == listener->IsSubscribed(static_cast<Event::Type>(type)));
+    }
+  }
+}
+
+TEST_CASE("AutoRepeat", "[game]") {
+  enum class Control { None, Left, SoftDrop };
+  using AutoRepeat = utility::AutoRepeat<Control>;
+
+  AutoRepeat auto_repeat(Control::None, Control::SoftDrop, 300, 50, 1);
+
+  REQUIRE(auto_repeat.Update(1000) == 0);
+  auto_repeat.Press(Control::Left, 1000);
+  REQUIRE(auto_repeat.Update(1299) == 0);
+  REQUIRE(auto_repeat.Update(1300) == 1);
+  REQUIRE(auto_repeat.Update(1349) == 0);
+  // A slow frame replays every repeat that was due
+  REQUIRE(auto_repeat.Update(1510) == 4);
+  REQUIRE(auto_repeat.Update(1550) == 1);
+
+  // The same presses give the same repeats at any frame rate
+  for (auto frame : { 1, 7, 16, 33, 100 }) {
+    int repeats = 0;
+
+    auto_repeat.Press(Control::Left, 0);
+    for (int now = 0; now <= 1000; now += frame) {
+      repeats += auto_repeat.Update(now);
+    }
+    repeats += auto_repeat.Update(1000);
+    REQUIRE(repeats == 15);
+  }
+  auto_repeat.Release(Control::SoftDrop);
+  REQUIRE(auto_repeat.control() == Control::Left);
+  auto_repeat.Release(Control::Left);
+  REQUIRE(auto_repeat.Update(5000) == 0);
+
+  auto_repeat.Set(100, 0, 10);
+  auto_repeat.Press(Control::Left, 0);
+  REQUIRE(auto_repeat.Update(99) == 0);
+  REQUIRE(auto_repeat.Update(100) == AutoRepeat::kRepeatToWall);
+  // Soft drop repeats without DAS
+  auto_repeat.Press(Control::SoftDrop, 0);
+  REQUIRE(auto_repeat.Update(4) == 0);
+  REQUIRE(auto_repeat.Update(50) == 10);
+  REQUIRE(auto_repeat.Update(100000) == AutoRepeat::kMaxRepeats);
+}
+
+TEST_CASE("WallPosition", "[matrix]") {
+  auto assets = std::make_shared<Assets>(nullptr);
+  const auto& tetrominos = assets->GetTetrominos();
+  const auto& t = tetrominos.at(static_cast<int>(Tetromino::Type::T) - 1)->GetRotationData(Tetromino::Angle::A0);
+  const auto& i = tetrominos.at(static_cast<int>(Tetromino::Type::I) - 1)->GetRotationData(Tetromino::Angle::A90);
+  auto matrix = std::make_shared<Matrix>(kSendLinesBefore, tetrominos);
+
+  for (const auto& rotation_data : { t, i }) {
+    for (int row = 0; row < kMatrixLastRow - 4; ++row) {
+      for (int col = 0; col < kMatrixLastCol; ++col) {
+        const Position pos(row, col);
+
+        if (!matrix->IsValid(pos, rotation_data)) {
+          continue;
+        }
+        for (auto direction : { -1, 1 }) {
+          Position expected(pos);
+
+          while (matrix->IsValid(Position(expected.row(), expected.col() + direction), rotation_data)) {
+            expected = Position(expected.row(), expected.col() + direction);
+          }
+          REQUIRE(matrix->GetWallPosition(pos, rotation_data, direction) == expected);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("EventScheduler", "[game]") {
+  auto drain = [](Events& events) {
+    std::vector<Event::Type> types;
+
+    while (!events.IsEmpty()) {
+      types.push_back(events.Pop().type());
+    }
+    return types;
+  };
+
+  Events events;
+
+  events.Push(Event::Type::OnFloor, Events::QueueRule::NoDuplicates);
+  events.Push(Event::Type::LevelUp, 2);
+  events.Push(Event::Type::OnFloor, Events::QueueRule::NoDuplicates);
+  events.PushFront(Event::Type::GameOver);
+  REQUIRE(events.IsQueued(Event::Type::OnFloor));
+  REQUIRE(drain(events) == std::vector<Event::Type>{ Event::Type::GameOver, Event::Type::LevelUp, Event::Type::OnFloor });
+  REQUIRE_FALSE(events.IsQueued(Event::Type::OnFloor));
+
+  events.Push(Event::Type::ClearOnFloor);
+  events.Remove(Event::Type::ClearOnFloor);
+  REQUIRE(events.IsEmpty(0.0));
+  events.Push(Event::Type::ClearOnFloor);
+  REQUIRE(drain(events) == std::vector<Event::Type>{ Event::Type::ClearOnFloor });
+
+  // Delayed events fire in due time order ahead of queued events, at any frame rate
+  for (auto frame : { 1.0 / 30, 1.0 / 60, 1.0 / 144, 0.5 }) {
+    events.Push(Event::Type::NextTetromino, 0.2);
+    events.Push(Event::Type::NewGame, 0.1);
+    events.Push(Event::Type::CanHold, 0.2);
+    events.Push(Event::Type::Moves);
+    REQUIRE_FALSE(events.IsEmpty(0.0));
+
+    std::vector<Event::Type> types;
+    double time = 0.0;
+
+    while (time < 0.25) {
+      time += frame;
+      events.IsEmpty(frame);
+      for (auto type : drain(events)) {
+        types.push_back(type);
+      }
+    }
+    REQUIRE(types.size() == 4);
+    REQUIRE(types.at(0) == ((frame < 0.1) ? Event::Type::Moves : Event::Type::NewGame));
+    REQUIRE(std::find(types.begin(), types.end(), Event::Type::NextTetromino) + 1 ==
+            std::find(types.begin(), types.end(), Event::Type::CanHold));
+  }
+  events.Push(Event::Type::NextTetromino, 0.2);
+  events.Push(Event::Type::Moves);
+  events.Clear();
+  REQUIRE(events.IsEmpty(1.0));
+}
+
+TEST_CASE("EventQueueRing", "[game]") {
+  RingBuffer<int> ring(3);
+
+  REQUIRE(ring.capacity() == 4);
+  for (int i = 0; i < 10; ++i) {
+    ring.push_back(i);
+    ring.push_front(-i);
+  }
+  REQUIRE(ring.size() == 20);
+  REQUIRE(ring.capacity() == 32);
+  for (int i = 9; i >= 0; --i) {
+    REQUIRE(ring.front() == -i);
+    ring.pop_front();
+  }
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(ring.front() == i);
+    ring.pop_front();
+  }
+  REQUIRE(ring.empty());
+
+  // More events than the preallocated capacity keep their order and payload
+  Events events;
+
+  for (int i = 0; i < static_cast<int>(Events::kQueueCapacity) * 2; ++i) {
+    events.Push(Event::Type::LinesCleared, i);
+  }
+  for (int i = 0; i < static_cast<int>(Events::kQueueCapacity) * 2; ++i) {
+    const auto event = events.Pop();
+
+    REQUIRE(event.Is(Event::Type::LinesCleared));
+    REQUIRE(event.value1_ == i);
+  }
+  REQUIRE(events.IsEmpty());
+}
@@ -1,4 +1,5 @@
 #include "test_utility.h"
+#include "game/tetromino_tspin_detection.h"
 
 #include "catch.hpp"
 
@@ -174,3 +175,49 @@ TEST_CASE("DetectTSpinMini") {
   REQUIRE(tspin_type == TSpinType::TSpinMini);
   REQUIRE_FALSE(perfect_clear);
 }
+
+TEST_CASE("DetectTSpinMiniKickUpgrade") {
+  auto [assets, matrix] = SetupTestHarness(kTSpinMiniMatrix);
+  Position insert_pos((kMatrixFirstRow - 2) + 18, kMatrixFirstCol + 4);
+
+  auto [lines_cleared, tspin_type, perfect_clear] =
+      matrix->Commit(Tetromino::Type::T, Tetromino::Angle::A270, Tetromino::Move::Rotation, insert_pos, kTSpinUpgradeKick);
+
+  REQUIRE(lines_cleared.size() == 1);
+  REQUIRE(tspin_type == TSpinType::TSpin);
+  REQUIRE_FALSE(perfect_clear);
+}
+
+const std::vector<std::vector<int>> kAllSpinMatrix {
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 01
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 02
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 03
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 04
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 05
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 06
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 07
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 08
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 09
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 10
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 11
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 12
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 13
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 14
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 15
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // 16
+  {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, // 17
+  {1, 1, 1, 1, 0, 0, 1, 1, 1, 1}, // 18
+  {1, 1, 1, 0, 0, 1, 1, 1, 1, 1}, // 19
+  {1, 1, 1, 1, 1, 1, 1, 1, 1, 0}  // 20
+};
+
+TEST_CASE("DetectAllSpin") {
+  auto [assets, matrix] = SetupTestHarness(kAllSpinMatrix);
+  Position insert_pos((kMatrixFirstRow - 2) + 19, kMatrixFirstCol + 3);
+
+  auto [lines_cleared, tspin_type, perfect_clear] = matrix->Commit(Tetromino::Type::S, Tetromino::Angle::A0, Tetromino::Move::Rotation, insert_pos);
+
+  REQUIRE(lines_cleared.size() == 2);
+  REQUIRE(tspin_type == TSpinType::AllSpin);
+  REQUIRE_FALSE(perfect_clear);
+}
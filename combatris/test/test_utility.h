@@ -1,7 +1,8 @@
 #include "game/matrix.h"
 #include "game/assets.h"
+#include "game/panes/level.h"
 
-#if defined(_WIN64)
+#if defined(_WIN64)
 #pragma warning(disable:4101) // conversion from size_t to int
 #endif
 
@@ -18,3 +19,20 @@ inline std::shared_ptr<Matrix> SetupTestHarnessMatrixOnly(const Matrix::Type& te
 
   return matrix;
 }
+
+// A matrix and a level that sprites can play on, the level has no renderer so nothing is drawn
+struct SpriteTestHarness {
+  explicit SpriteTestHarness(const Matrix::Type& test_matrix)
+      : assets_(std::make_shared<Assets>(nullptr)),
+        matrix_(std::make_shared<Matrix>(test_matrix, assets_->GetTetrominos())),
+        level_(std::make_shared<Level>(nullptr, 0, events_, assets_)) {}
+
+  SpriteTestHarness(const SpriteTestHarness&) = delete;
+
+  const Tetromino& tetromino(Tetromino::Type type) const { return *assets_->GetTetromino(type); }
+
+  std::shared_ptr<Assets> assets_;
+  std::shared_ptr<Matrix> matrix_;
+  Events events_;
+  std::shared_ptr<Level> level_;
+};
@@ -0,0 +1,172 @@
+#include "game/events.h"
+#include "game/tetromino.h"
+#include "utility/render_batch.h"
+#include "utility/trace.h"
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if !defined(_WIN64)
+#include <csignal>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::vector<utility::TraceRecord> ReadTrace(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  char header[24];
+  uint64_t count;
+
+  file.read(header, sizeof(header));
+  std::memcpy(&count, header + 16, sizeof(count));
+
+  std::vector<utility::TraceRecord> records(count);
+
+  file.read(reinterpret_cast<char*>(records.data()), count * sizeof(utility::TraceRecord));
+  REQUIRE(file.gcount() == static_cast<std::streamsize>(count * sizeof(utility::TraceRecord)));
+
+  return records;
+}
+
+} // namespace
+
+TEST_CASE("TraceDump", "[utility]") {
+  const std::string kFileName = "combatris_test.trace";
+  Events events;
+
+  events.Push(Event::Type::LinesCleared, 4);
+  events.Push(Event::Type::NextTetromino, 0.2);
+  events.Pop();
+  utility::Trace::Record(utility::TraceKind::NetworkSend, 6, 4711);
+  REQUIRE(utility::Trace::Dump(kFileName));
+
+  std::ifstream file(kFileName, std::ios::binary);
+  char magic[8];
+  uint32_t version, record_size;
+  uint64_t count;
+
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&record_size), sizeof(record_size));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  REQUIRE(std::equal(std::begin(magic), std::end(magic), std::begin(utility::Trace::kMagic)));
+  REQUIRE(version == 1);
+  REQUIRE(record_size == sizeof(utility::TraceRecord));
+  REQUIRE(count >= 4);
+  REQUIRE(count <= utility::Trace::kCapacity);
+
+  std::vector<utility::TraceRecord> records(count);
+
+  file.read(reinterpret_cast<char*>(records.data()), count * sizeof(utility::TraceRecord));
+  REQUIRE(file.gcount() == static_cast<std::streamsize>(count * sizeof(utility::TraceRecord)));
+
+  const auto& last = records.back();
+
+  REQUIRE(last.kind_ == utility::TraceKind::NetworkSend);
+  REQUIRE(last.value1_ == 4711);
+  REQUIRE(records.at(count - 2).kind_ == utility::TraceKind::EventPop);
+  REQUIRE(records.at(count - 2).value1_ == 4);
+  REQUIRE(records.at(count - 3).kind_ == utility::TraceKind::EventSchedule);
+  REQUIRE(records.at(count - 4).kind_ == utility::TraceKind::EventPush);
+  REQUIRE(std::is_sorted(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.timestamp_ < b.timestamp_; }));
+  file.close();
+  std::remove(kFileName.c_str());
+}
+
+TEST_CASE("TraceConcurrentDump", "[utility]") {
+  const std::string kFileName = "combatris_test_concurrent.trace";
+  const int kThreads = 4;
+  const uint32_t kRecordsPerThread = 200000;
+  std::vector<std::thread> threads;
+
+  for (int id = 1; id <= kThreads; ++id) {
+    threads.emplace_back([id, kRecordsPerThread] {
+      for (uint32_t i = 0; i < kRecordsPerThread; ++i) {
+        utility::Trace::Record(utility::TraceKind::NetworkReceive, static_cast<uint8_t>(id), id, (static_cast<uint64_t>(id) << 32) | i);
+      }
+    });
+  }
+  // Every record in a dump taken while the threads record is whole
+  for (int dump = 0; dump < 10; ++dump) {
+    REQUIRE(utility::Trace::Dump(kFileName));
+    for (const auto& record : ReadTrace(kFileName)) {
+      if (utility::TraceKind::NetworkReceive == record.kind_) {
+        REQUIRE(record.code_ == record.value1_);
+        REQUIRE(static_cast<int32_t>(record.value2_ >> 32) == record.value1_);
+      }
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // A slot lost to a writer that wrapped around is taken back by the next record in it
+  for (uint32_t i = 0; i < utility::Trace::kCapacity; ++i) {
+    utility::Trace::Record(utility::TraceKind::NetworkReceive, 0, 0, i);
+  }
+  REQUIRE(utility::Trace::Dump(kFileName));
+  REQUIRE(ReadTrace(kFileName).size() == utility::Trace::kCapacity);
+  std::remove(kFileName.c_str());
+}
+
+#if !defined(_WIN64)
+TEST_CASE("TraceDumpOnCrash", "[utility]") {
+  const std::string kFileName = "combatris_test_crash.trace";
+  const auto pid = fork();
+
+  if (0 == pid) {
+    utility::Trace::DumpOnCrash(kFileName);
+    utility::Trace::Record(utility::TraceKind::NetworkSend, 7, 4712);
+    std::abort();
+  }
+  int status = 0;
+
+  REQUIRE(pid > 0);
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFSIGNALED(status));
+  REQUIRE(WTERMSIG(status) == SIGABRT);
+
+  const auto records = ReadTrace(kFileName);
+
+  REQUIRE_FALSE(records.empty());
+  REQUIRE(records.back().kind_ == utility::TraceKind::NetworkSend);
+  REQUIRE(records.back().value1_ == 4712);
+  std::remove(kFileName.c_str());
+}
+#endif
+
+TEST_CASE("MinoAtlasBatch", "[utility]") {
+  for (int id = kEmptyID + 1; id <= kMinoAtlasWhiteID; ++id) {
+    const auto rc = MinoAtlasRect(id);
+
+    REQUIRE(rc.x == (id - 1) * kMinoWidth);
+    REQUIRE(rc.x + rc.w <= kMinoAtlasCells * kMinoWidth);
+  }
+  const SDL_Rect clip_rc { 0, 0, 100, 100 };
+  const auto atlas_rc = MinoAtlasRect(kBorderID);
+  utility::RenderBatch batch(4);
+  auto same = [](const SDL_Rect& a, const SDL_Rect& b) { return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h; };
+
+  batch.Add({ 10, 10, kMinoWidth, kMinoHeight }, atlas_rc, clip_rc);
+  batch.Add({ 90, 90, kMinoWidth, kMinoHeight }, atlas_rc, clip_rc);
+  batch.Add({ 100, 10, kMinoWidth, kMinoHeight }, atlas_rc, clip_rc);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(same(batch.src_rc(0), atlas_rc));
+  // Only the top left 10x10 corner of the mino is inside the clip rect
+  REQUIRE(same(batch.dest_rc(1), { 90, 90, 10, 10 }));
+  REQUIRE(same(batch.src_rc(1), { atlas_rc.x, atlas_rc.y, 10, 10 }));
+  // Drawn at twice the size, half as much of the source is clipped
+  batch.Add({ -16, 84, 2 * kMinoWidth, 2 * kMinoHeight }, atlas_rc, clip_rc);
+  REQUIRE(same(batch.dest_rc(2), { 0, 84, 2 * kMinoWidth - 16, 16 }));
+  REQUIRE(same(batch.src_rc(2), { atlas_rc.x + 8, atlas_rc.y, kMinoWidth - 8, 8 }));
+  batch.Add({ 100, 10, kMinoWidth, kMinoHeight }, MinoAtlasRect(kMinoAtlasWhiteID));
+  REQUIRE(batch.size() == 4);
+  batch.Clear();
+  REQUIRE(batch.size() == 0);
+}
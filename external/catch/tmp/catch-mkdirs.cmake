@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/external/catch/src/catch"
+  "/root/repo/external/catch/src/catch-build"
+  "/root/repo/external/catch"
+  "/root/repo/external/catch/tmp"
+  "/root/repo/external/catch/src/catch-stamp"
+  "/root/repo/external/catch/src"
+  "/root/repo/external/catch/src/catch-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/external/catch/src/catch-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/external/catch/src/catch-stamp${cfgdir}") # cfgdir has leading slash
+endif()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+#
+# Turns a Combatris trace dump (combatris.trace, written on F12 or on a crash) into a readable timeline.
+#
+#   decode_trace.py combatris.trace
+#   decode_trace.py --kind network --gaps 20 combatris.trace
+#
+# The names below must follow the enums in combatris/src/game/events.h, tetromino.h, tetromino_sprite.h,
+# network/protocol.h and utility/trace.h.
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'CBTRACE1'
+HEADER = struct.Struct('<8sIIQ')
+RECORD = struct.Struct('<qBBHiQ')
+
+KINDS = ['None', 'EventPush', 'EventSchedule', 'EventPop', 'SpriteState', 'NetworkSend', 'NetworkReceive']
+
+EVENT_TYPES = [
+    'None', 'Pause', 'UnPause', 'NewGame', 'NextTetromino', 'DropScoreData', 'ClearedLinesScoreData',
+    'CalculatedScore', 'Moves', 'LevelUp', 'SetStartLevel', 'LinesCleared', 'OnFloor', 'ClearOnFloor',
+    'CountdownAfterUnPauseDone', 'GameOver', 'GameStatistics', 'PerfectClear', 'SetCampaign', 'NewTime',
+    'CanHold', 'SprintClearedAll', 'MenuSetModeAndCampaign', 'MultiplayerCampaignOver', 'PlayerRejected',
+    'MultiPlayerSetSeed', 'MultiplayerStartGame', 'MultiplayerResetCountDown', 'ShowSplashScreen', 'RoyalNewLine',
+    'BattleSendLines', 'BattleGotLines', 'BattleKnockedOut', 'BattleYouDidKO', 'BattleNextTetrominoSuccessful',
+    'HideMultiPlayerPanel', 'MenuSetRotationSystem', 'MenuSetRandomizer'
+]
+
+SPRITE_STATES = ['Generated', 'Falling', 'OnFloor', 'Commit', 'Commited', 'GameOver', 'KO']
+
+TETROMINOS = ['Empty', 'I', 'J', 'L', 'O', 'S', 'T', 'Z', 'Solid', 'Bomb', 'Border']
+
+REQUESTS = ['Empty', 'Join', 'Leave', 'NewGame', 'StartGame', 'NewState', 'SendLines', 'KnockedOutBy', 'Time',
+            'ProgressUpdate', 'HeartBeat']
+
+FILTERS = {
+    'event': {'EventPush', 'EventSchedule', 'EventPop'},
+    'sprite': {'SpriteState'},
+    'network': {'NetworkSend', 'NetworkReceive'},
+}
+
+
+def name(names, index):
+    return names[index] if index < len(names) else '#{}'.format(index)
+
+
+def describe(kind, code, value1, value2):
+    if kind in ('EventPush', 'EventPop'):
+        return '{:<30} value1={} value2={}'.format(name(EVENT_TYPES, code), value1, value2)
+    if kind == 'EventSchedule':
+        return '{:<30} in {:.3f} ms'.format(name(EVENT_TYPES, code), value1 / 1000.0)
+    if kind == 'SpriteState':
+        row, col = value2 >> 32, value2 & 0xFFFFFFFF
+        return '{:<30} {} at row {} col {}'.format(name(SPRITE_STATES, code), name(TETROMINOS, value1), row, col)
+    if kind == 'NetworkSend':
+        return '{:<30} sequence {}'.format(name(REQUESTS, code), value1)
+    if kind == 'NetworkReceive':
+        return '{:<30} from host {:#018x}'.format(name(REQUESTS, code), value2)
+    return ''
+
+
+def read_records(file_name):
+    with open(file_name, 'rb') as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit('{}: too short to be a trace'.format(file_name))
+    magic, version, record_size, count = HEADER.unpack_from(data)
+    if magic != MAGIC or version != 1 or record_size != RECORD.size:
+        sys.exit('{}: not a version 1 Combatris trace'.format(file_name))
+    count = min(count, (len(data) - HEADER.size) // RECORD.size)
+    return [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(count)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a Combatris trace dump into a timeline')
+    parser.add_argument('trace', help='trace file written by the game')
+    parser.add_argument('--kind', choices=sorted(FILTERS), help='only show records of this kind')
+    parser.add_argument('--gaps', type=float, metavar='MS', help='mark gaps between records longer than MS')
+    args = parser.parse_args()
+
+    records = read_records(args.trace)
+    if not records:
+        print('Empty trace')
+        return
+    start = records[0][0]
+    previous = start
+
+    for timestamp, kind, code, _, value1, value2 in records:
+        kind = name(KINDS, kind)
+        if args.gaps is not None and (timestamp - previous) / 1e6 > args.gaps:
+            print('{:>14} --- gap of {:.3f} ms'.format('', (timestamp - previous) / 1e6))
+        previous = timestamp
+        if args.kind and kind not in FILTERS[args.kind]:
+            continue
+        print('{:14.6f} {:<15} {}'.format((timestamp - start) / 1e6, kind, describe(kind, code, value1, value2)))
+
+    print('{} records over {:.3f} ms'.format(len(records), (records[-1][0] - start) / 1e6))
+
+
+if __name__ == '__main__':
+    main()